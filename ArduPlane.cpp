@@ -85,25 +85,48 @@ const AP_Scheduler::Task Plane::scheduler_tasks[] = {
     SCHED_TASK(dataflash_periodic,     50,    400),
     SCHED_TASK(avoidance_adsb_update,  10,    100),
     SCHED_TASK(button_update,           5,    100),
+    SCHED_TASK(update_TLAB_params,     10,    100),
 };
 
+// time since the last call [us], for timing the phases of setup()
+static uint32_t boot_lap_us(uint32_t &t)
+{
+    uint32_t now = AP_HAL::micros();
+    uint32_t dt = now - t;
+    t = now;
+    return dt;
+}
+
 void Plane::setup() 
 {
     cliSerial = hal.console;
 
+    // NԂ̌v
+    uint32_t boot_t = AP_HAL::micros();
+
     // load the default values of variables listed in var_info[]
     AP_Param::setup_sketch_defaults();
+    tlab_boot.defaults_us = boot_lap_us(boot_t);
 
     AP_Notify::flags.failsafe_battery = false;
 
     notify.init(false);
+    tlab_boot.notify_us = boot_lap_us(boot_t);
 
     rssi.init();
+    tlab_boot.rssi_us = boot_lap_us(boot_t);
 
     init_ardupilot();
+    tlab_boot.init_us = boot_lap_us(boot_t);
+
+    init_TLAB_params();
+    init_TLAB_path_tables();
+    tlab_boot.tlab_us = boot_lap_us(boot_t);
 
     // initialise the main loop scheduler
     scheduler.init(&scheduler_tasks[0], ARRAY_SIZE(scheduler_tasks));
+    tlab_boot.sched_us = boot_lap_us(boot_t);
+    tlab_boot.setup_ms = AP_HAL::millis();
 }
 
 void Plane::loop()
@@ -158,6 +181,7 @@ void Plane::ahrs_update()
 #endif
 
     ahrs.update();
+    tlab_ahrs_us = AP_HAL::micros64();
 
     if (should_log(MASK_LOG_IMU)) {
         Log_Write_IMU();
@@ -335,6 +359,15 @@ void Plane::one_second_loop()
     AP_Notify::flags.pre_arm_gps_check = true;
     AP_Notify::flags.armed = arming.is_armed() || arming.arming_required() == AP_Arming::NO;
 
+    // N arm \ɂȂ܂ł̎ԂL^
+    if (tlab_boot.armable_ms == 0 && AP_Notify::flags.pre_arm_check) {
+        tlab_boot.armable_ms = AP_HAL::millis();
+        gcs_send_text_fmt(MAV_SEVERITY_INFO, "Armable %.1fs after boot (setup %.1fs)",
+                          (double)(tlab_boot.armable_ms*0.001f),
+                          (double)(tlab_boot.setup_ms*0.001f));
+        Log_Write_PPG_Boot();
+    }
+
 #if AP_TERRAIN_AVAILABLE
     if (should_log(MASK_LOG_GPS)) {
         terrain.log_terrain_data(DataFlash);
@@ -343,6 +376,11 @@ void Plane::one_second_loop()
 
     ins.set_raw_logging(should_log(MASK_LOG_IMU_RAW));
 
+    if (should_log(MASK_LOG_NTUN)) {
+        Log_Write_PPG_Metrics();
+        Log_Write_PPG_Filter();
+    }
+
     // update home position if soft armed and gps position has
     // changed. Update every 5s at most
     if (!hal.util->get_soft_armed() &&
@@ -437,6 +475,9 @@ void Plane::update_GPS_50Hz(void)
 {
     // get position from AHRS
     have_position = ahrs.get_position(current_loc);
+    if (have_position) {
+        tlab_loc_us = AP_HAL::micros64();
+    }
 
     static uint32_t last_gps_reading[GPS_MAX_INSTANCES];
     gps.update();
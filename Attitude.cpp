@@ -1,6 +1,7 @@
 // -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
 
 #include "Plane.h"
+#include "TLAB_FastMath.h"
 
 /*
   get a speed scaling number for control surfaces. This is applied to
@@ -374,6 +375,7 @@ void Plane::stabilize()
     if(init_TLAB_Controller_flag){
         init_TLAB_Controller();
     }
+    swap_TLAB_params();
     if (control_mode == MANUAL) {
         // nothing to do
         return;
@@ -628,15 +630,13 @@ int32_t Plane::TLAB_Throttle_Controller(void)
     int32_t z_r_cm = next_WP_loc.alt;
     z = z_cm * 0.01f;  // POSx [m]
     z_r= z_r_cm * 0.01f;
-    uint64_t current_time_Th =  AP_HAL::micros64();
 
     if(firsttime_Th){
         firsttime_Th = false;
-        z_old = z_cm;
-        pitch_old=ahrs.pitch;
         dz = 0;
-        err_count = 0;
-        prev_time_Th = current_time_Th;
+        speed_pitch = 0;
+        tlab_ab_z.reset();
+        tlab_ab_pitch.reset();
         d1_Th = g.TPARAM_pdc_height_d1_Th;
         d2_Th = g.TPARAM_pdc_height_d2_Th;
         kp_Th[0] = g.TPARAM_height_kp0_Th;
@@ -645,46 +645,20 @@ int32_t Plane::TLAB_Throttle_Controller(void)
         kd_Th[1] = g.TPARAM_height_kd1_Th;
         motor_neutral = g.TPARAM_motor_neutral_Th;
     }
-    past_time_Th = current_time_Th - prev_time_Th;
-    float past_time_Th_f = (float)past_time_Th;
-    past_time_Th_f *= 1e-6;
-//    if (z_cm == z_old || past_time_Th == 0){
-//        err_count++;
-//    }else{
-//        int32_t dz_int = z_cm - z_old;
-//        float dz_f = (float)dz_int;
-//        dz = dz_f*0.01/(past_time_Th_f);
-//        z_old = z_cm;
-//        prev_time_Th = current_time_Th;
-//    }
-//    if (ahrs.pitch == pitch_old || past_time_Th == 0){
-//            err_count++;
-//        }else{
-//            d_pitch = ahrs.pitch - pitch_old;
-//            //float dz_f = (float)dz_int;
-//            speed_pitch = d_pitch/(past_time_Th_f);
-//            pitch_old = ahrs.pitch;
-//            prev_time_Th = current_time_Th;
-//        }
-    //
-    if (past_time_Th == 0){
-            err_count++;
-            z_old = z_cm;
-            pitch_old = ahrs.pitch;
-            prev_time_Th = current_time_Th;
-        }else{
-            int32_t dz_int = z_cm - z_old;
-            dz_f = (float)dz_int;
-            d_pitch = ahrs.pitch - pitch_old;
-            dz = dz_f*0.01/(past_time_Th_f);  // x̎Ԕ [m/s]
-            speed_pitch = d_pitch/(past_time_Th_f);
-            z_old = z_cm;
-            pitch_old = ahrs.pitch;
-            prev_time_Th = current_time_Th;
-        }
+    // ̂܂ܔƂ, 1cm Pʂ̍x̗ʎq 400Hz ł 4m/s ̒iɂȂ.
+    // -tB^Ő肵ωg(萔0ŏ]̍Ɠ).
+    // current_loc  50Hz (update_GPS_50Hz), p ahrs_update() ōXV̂, XVꂽn
+    // VTv̂ƂtB^i߂(lJԂƕω0Ɉ񂹂邽)
+    tlab_ab_z.update(z, tlab_loc_us, tparam->tau_dz);
+    tlab_ab_pitch.update(ahrs.pitch, tlab_ahrs_us, tparam->tau_dpitch);
+    dz = tlab_ab_z.get_rate();  // x̎Ԕ [m/s]
+    speed_pitch = tlab_ab_pitch.get_rate();
+    past_time_Th = tlab_ab_z.get_dt_us();  // xTv̊Ԋu [us] (Op)
     //
     e_m = z - z_r;  // x̐΍ [m]
     de_m = dz;  // x̎Ԕ [m/s]
+    tlab_metrics.n_alt++;
+    tlab_metrics.sum_e_m2 += e_m*e_m;
     h_Th[0] = constrain_float((de_m - d2_Th)/(d1_Th - d2_Th),0.0f,1.0f);
     h_Th[1] = constrain_float((d1_Th - de_m)/(d1_Th - d2_Th),0.0f,1.0f);
     gps_dh = -gps.velocity().z;//add by aoki
@@ -692,32 +666,32 @@ int32_t Plane::TLAB_Throttle_Controller(void)
 
     //2.49(N)t_i~bVvi[́j
     //̎gpĕt_(N)̌vZ
-    if(g.TPARAM_cha_pow == 1){
+    if(tparam->cha_pow == 1){
     	//PD? Controller(Iwase or Nishizuka)
-        motor_Th_N = (1/cosf(g.TPARAM_theta_a*M_PI/180))*(0.1059*g.TPARAM_V_a*g.TPARAM_V_a-0.3342*g.TPARAM_V_a +1.6227);
+        motor_Th_N = tparam->airpower;
     for(int i = 0; i <= 1; i++){
         motor_Th_N += -h_Th[i]*(kp_Th[i]*e_m  + kd_Th[i]*de_m);
     }
-    }else if(g.TPARAM_cha_pow == 2){
+    }else if(tparam->cha_pow == 2){
     	//SOS Controller(Nishizuka)
         motor_Th_N = motor_neutral;
-        F1=0.0080059*e_m-0.0057775*de_m+0.17926*(ahrs.pitch-g.TPARAM_theta_a*M_PI/180)+0.049755*speed_pitch+0.3259;
-        F2=-0.0057775*e_m-0.0011929*de_m+0.063286*(ahrs.pitch-g.TPARAM_theta_a*M_PI/180)-0.020788*speed_pitch+0.09056;
-        F3=0.17926*e_m+0.063286*de_m+5.1494*(ahrs.pitch-g.TPARAM_theta_a*M_PI/180)+0.52875*speed_pitch+16.1688;
-        F4=0.049755*e_m-0.020788*de_m+0.52875*(ahrs.pitch-g.TPARAM_theta_a*M_PI/180)+0.19909*speed_pitch+2.9633;
+        F1=0.0080059*e_m-0.0057775*de_m+0.17926*(ahrs.pitch-tparam->theta_a_rad)+0.049755*speed_pitch+0.3259;
+        F2=-0.0057775*e_m-0.0011929*de_m+0.063286*(ahrs.pitch-tparam->theta_a_rad)-0.020788*speed_pitch+0.09056;
+        F3=0.17926*e_m+0.063286*de_m+5.1494*(ahrs.pitch-tparam->theta_a_rad)+0.52875*speed_pitch+16.1688;
+        F4=0.049755*e_m-0.020788*de_m+0.52875*(ahrs.pitch-tparam->theta_a_rad)+0.19909*speed_pitch+2.9633;
       //  motor_Th_N +=-(F1*e_m+F2*de_m+F3*(ahrs.pitch-g.TPARAM_theta_a*M_PI/180)+F4*speed_pitch);
         motor_Th_N +=-(F1*e_m+F2*de_m);
-    }else if(g.TPARAM_cha_pow == 3){
+    }else if(tparam->cha_pow == 3){
     	//PD Controller
         motor_Th_N = motor_neutral;
         motor_Th_N +=-(kp_Th[0]*e_m + kd_Th[0]*de_m);
-    }else if(g.TPARAM_cha_pow == 4){
+    }else if(tparam->cha_pow == 4){
     	//LQR Controller, but not done yet, added by hatae
     	motor_Th_N = 0;
-    }else if(g.TPARAM_cha_pow == 5){
+    }else if(tparam->cha_pow == 5){
     	//KI Controller, but not done yet, added by hatae
     	motor_Th_N = 0;
-    }else if(g.TPARAM_cha_pow == 6){
+    }else if(tparam->cha_pow == 6){
     	//LMI controller, added by hatae 2021/7/28
     	//萔
     	float c_m_1=1.700f*pow(10.0f,-1.0f); //small m
@@ -734,12 +708,18 @@ int32_t Plane::TLAB_Throttle_Controller(void)
     	float c_D=c_rho*c_C_D*c_S;
 
     	//Rg[I(tB[hobNQC)
-    	int num=g.TPARAM_c_alt;
+    	int num=tparam->c_alt;
     	//őlŏlݒ
         float maxmin_z[3][2];
         //tB[hobNQCw
-        float f[8][4];
-        switch_controller_alt(num,f,maxmin_z);
+        TLAB_Matrix<8,4> f;
+        // SDJ[h̃QCe[u(8x4, Oϐ3)΂g, Ȃ΃R[h̃e[ug
+        if (tlab_gain != nullptr && tlab_gain->n_rules == 8 && tlab_gain->n_states == 4 && tlab_gain->n_premise == 3) {
+            f.load(&tlab_gain->F[0][0], TLAB_GAIN_MAX_STATES);
+            memcpy(maxmin_z, tlab_gain->z, sizeof(maxmin_z));
+        } else {
+            switch_controller_alt(num,f.m,maxmin_z);
+        }
         //t_̕ϐ
         float theta_n=15.8f/180.0f*M_PI;
         float T_neutral=4.46f;
@@ -753,7 +733,7 @@ int32_t Plane::TLAB_Throttle_Controller(void)
         float mem_M[2];
         float mem_N[2];
         float mem_L[2];
-        float h[8];
+        TLAB_Vector<8> h;
         //oVbv֐
         mem_M[0]=constrain_float((maxmin_z[0][0]-z1)/(maxmin_z[0][0]-maxmin_z[0][1]),0.0f,1.0f);
         mem_M[1]=constrain_float((z1-maxmin_z[0][1])/(maxmin_z[0][0]-maxmin_z[0][1]),0.0f,1.0f);
@@ -780,23 +760,19 @@ int32_t Plane::TLAB_Throttle_Controller(void)
         h_5=h[5];
         h_6=h[6];
         h_7=h[7];
-        float x_r[4]={e_m,gps_dh,theta_r,gps_dpitch};
+        TLAB_Vector<4> x_r = {{e_m,gps_dh,theta_r,gps_dpitch}};
         //͌vZ
-        motor_Th_N=T_neutral;
-        float motor_Th_N_i;
-        for (int i=0;i<8;i++){
-        	motor_Th_N_i=0;
-        	for (int j=0;j<4;j++){
-        		motor_Th_N_i+=f[i][j]*x_r[j];
-        	}
-        	motor_Th_N+=-h[i]*motor_Th_N_i;
-        }
+        motor_Th_N = tlab_fuzzy_feedback(T_neutral, h, f, x_r);
     }
     //motor_Th_NXsRϊp̃vOʂ%o͂ɂȂ
     motor_per = thrust_to_percent(motor_Th_N);
     return static_cast<int32_t>(motor_per);
 }
 
+// ̓}bv thrust = kk*(a*percent^2 + c) ̌W
+static const float thrust_map_a = 0.002287471638222f;
+static const float thrust_map_c = 0.069756864241495f;
+
 //
 float Plane::thrust_to_percent(float thrust) {
 
@@ -819,12 +795,13 @@ float Plane::thrust_to_percent(float thrust) {
 //            return constrain_int32(value, 0, 100);
 //        }
 //    }else{
-            float a = 0.002287471638222;
-            float c = 0.069756864241495;
+            const float a = thrust_map_a;
+            const float c = thrust_map_c;
             //float offset = -0.117384315454501;
-            airpower = (1/cosf(g.TPARAM_theta_a*M_PI/180))*(0.1059*g.TPARAM_V_a*g.TPARAM_V_a-0.3342*g.TPARAM_V_a +1.6227);
+            // airpower, kk ̓XibvVbgŌvZς
+            airpower = tparam->airpower;
             //float motor_neutral_2 = sqrtf((motor_neutral - c) / a);
-            kk = (airpower)/(a*g.TPARAM_neutral_t*g.TPARAM_neutral_t + c);
+            kk = tparam->kk;
             int32_t value = (int32_t) ((sqrtf((thrust - c*kk) / (a*kk))));
                  value1 = value;
                      if (value1<0){
@@ -838,7 +815,7 @@ float Plane::thrust_to_percent(float thrust) {
             if (thrust < 0.3256)
                 return 0;
            else {
-                return constrain_int32(value, 0, g.TPARAM_MAX_slo);
+                return constrain_int32(value, 0, tparam->MAX_slo);
 //            }
     }
 }
@@ -895,11 +872,11 @@ void Plane::calc_nav_yaw_coordinated(float speed_scaler)
     */
 
     // Added by Kaito Yamamoto 2021.08.11.
-    if (g.TPARAM_Bar_Control_Mode == 1) {
+    if (tparam->Bar_Control_Mode == 1) {
     	// ߋ̒Ǐ]Rg[  "g.TPARAM_switch_mo" ŃRg[؂ւ
     	steering_control.rudder = constrain_int16(TLAB_Line_Trace_Controller(), -4500, 4500);
     }
-    else if (g.TPARAM_Bar_Control_Mode == 2) {
+    else if (tparam->Bar_Control_Mode == 2) {
     	// MPŎw肷 "g.TPARAM_s_neutral" [deg]̈lT[{[^[pxƂďo͂
     	steering_control.rudder = constrain_int16(TLAB_Constant_Output(), -4500, 4500);
     }
@@ -925,8 +902,6 @@ void Plane::init_TLAB_Controller(void)
     alpha_max = g.TPARAM_alpha_max*M_PI/180.0f;
     r_min = g.TPARAM_r_min;
     target_R = g.TPARAM_R;
-    U_min = g.TPARAM_U_min;
-    U_max = g.TPARAM_U_max;
     // rt@WBp
     if (g.TPARAM_rule_num != 0) {
         use_fuzzy_controller = true;
@@ -953,6 +928,91 @@ void Plane::init_TLAB_Controller(void)
     }
     change_y = g.TPARAM_change_y;
     orbit_num = g.TPARAM_orbit_num;
+    init_TLAB_params();
+}
+
+
+/*
+ * "p[^̃XibvVbg"
+ * Tv: g.TPARAM_* 10HzŊĎ, ύXƂҋ@̃XibvVbgČvZ.
+ *       MAVLink  PARAM_SET, p[^̍ēǂݍ݂̂ǂɂύXŌo.
+ *       ؂ւ stabilize() ̐擪(tickE)ōs, 1̐vZ̓rŒlς邱Ƃ͂Ȃ.
+*/
+void Plane::update_TLAB_params(void){
+	update_TLAB_gain_table();
+	update_TLAB_mission_cache();
+
+	TLAB_Param_Raw raw;
+	memset(&raw, 0, sizeof(raw));  // pfBO܂߂Ĕr邽
+	raw.theta_a = g.TPARAM_theta_a;
+	raw.V_a = g.TPARAM_V_a;
+	raw.servo_neutral = g.TPARAM_servo_neutral;
+	raw.U_min = g.TPARAM_U_min;
+	raw.U_max = g.TPARAM_U_max;
+	raw.control_a = g.TPARAM_control_a;
+	raw.control_b = g.TPARAM_control_b;
+	raw.control_p = g.TPARAM_control_p;
+	raw.L_1 = g.TPARAM_L_1;
+	raw.r = g.TPARAM_r;
+	raw.tau_dz = g.TPARAM_tau_dz;
+	raw.tau_dpitch = g.TPARAM_tau_dpitch;
+	raw.neutral_t = g.TPARAM_neutral_t;
+	raw.MAX_slo = g.TPARAM_MAX_slo;
+	raw.cha_pow = g.TPARAM_cha_pow;
+	raw.switch_mo = g.TPARAM_switch_mo;
+	raw.c_alt = g.TPARAM_c_alt;
+	raw.Bar_Control_Mode = g.TPARAM_Bar_Control_Mode;
+
+	if (tparam != nullptr && memcmp(&raw, &tlab_param_raw, sizeof(raw)) == 0) {
+		return;  // ύXȂ
+	}
+	memcpy(&tlab_param_raw, &raw, sizeof(raw));
+
+	// ҋ@ɍČvZ(LtickE܂ŕύXȂ)
+	TLAB_Param_Snapshot &p = tlab_param[tlab_param_idx ^ 1];
+	p.theta_a_rad = raw.theta_a*M_PI/180.0f;
+	p.airpower = (1/cosf(p.theta_a_rad))*(0.1059f*raw.V_a*raw.V_a - 0.3342f*raw.V_a + 1.6227f);
+	p.kk = p.airpower/(thrust_map_a*raw.neutral_t*raw.neutral_t + thrust_map_c);
+	p.servo_neutral_rad = raw.servo_neutral*M_PI/180.0f;
+	p.servo_neutral_cd = raw.servo_neutral*100.0f;
+	p.U_min_rad = raw.U_min*M_PI/180.0f;
+	p.U_max_rad = raw.U_max*M_PI/180.0f;
+	p.control_a = raw.control_a;
+	p.control_b = raw.control_b;
+	p.control_p = raw.control_p;
+	p.L_1 = raw.L_1;
+	p.r = raw.r;
+	p.r_inv = is_zero(raw.r) ? 0.0f : 1.0f/raw.r;
+	p.tau_dz = MAX(raw.tau_dz, 0.0f);
+	p.tau_dpitch = MAX(raw.tau_dpitch, 0.0f);
+	p.MAX_slo = raw.MAX_slo;
+	p.cha_pow = raw.cha_pow;
+	p.switch_mo = raw.switch_mo;
+	p.c_alt = raw.c_alt;
+	p.Bar_Control_Mode = raw.Bar_Control_Mode;
+	tlab_param_pending = true;
+}
+
+void Plane::swap_TLAB_params(void){
+	const TLAB_GainTable *prev_gain = tlab_gain;
+	swap_TLAB_gain_table();
+
+	if (!tlab_param_pending) {
+		if (tlab_gain != prev_gain) {
+			tlab_metrics.gain_hash = TLAB_gain_hash();  // PTRK ̃QCnbV؂ւ̑gɍ킹
+		}
+		return;
+	}
+	tlab_param_idx ^= 1;
+	tparam = &tlab_param[tlab_param_idx];
+	tlab_param_pending = false;
+	tlab_metrics.gain_hash = TLAB_gain_hash();
+}
+
+void Plane::init_TLAB_params(void){
+	memset(&tlab_param_raw, 0xff, sizeof(tlab_param_raw));  // KČvZ
+	update_TLAB_params();
+	swap_TLAB_params();
 }
 
 void Plane::init_TLAB_Controller_AUTO(void)
@@ -1055,11 +1115,9 @@ float Plane::calc_controller(float x1, float x2)
             h_mem[2] = m_mem[1]*n_mem[0];
             h_mem[3] = m_mem[1]*n_mem[1];
         }
-        float u_control = 0;
-        for(int i = 0;i < rule_num; i++){
-            u_control -= h_mem[i]*(F_fuzzy[i][0]*x1 + F_fuzzy[i][1]*x2);
-        }
-        return u_control;
+        // rule_num == 2 ̂Ƃ h_mem[2], h_mem[3] 0
+        TLAB_Vector<2> x_fuzzy = {{x1, x2}};
+        return tlab_fuzzy_feedback(0.0f, h_mem, F_fuzzy, x_fuzzy);
     }
     return 0;
 }
@@ -1090,9 +1148,17 @@ float sqn(const float x){
 
 int32_t Plane::TLAB_Line_Trace_Controller()
 {
-    Dist_currWP2UAV = get_distance(current_loc, prev_WP_loc);
-    rad_prevWP2UAV = (float)(get_bearing_cd(prev_WP_loc, current_loc)*0.01*M_PI/180.0);
-    rad_prevWP2currWP = (float)(get_bearing_cd(prev_WP_loc, next_WP_loc)*0.01*M_PI/180.0);
+    // OWP_ƂČݒn_ƎWPxɌvZ(cos(lat) 1, ʂ [rad] Œڋ߂)
+    TLAB_GeoOrigin prev_WP;
+    tlab_geo_set_origin(prev_WP, prev_WP_loc);
+    const int32_t lat[2] = {current_loc.lat, next_WP_loc.lat};
+    const int32_t lng[2] = {current_loc.lng, next_WP_loc.lng};
+    float dist[2], bearing[2];
+    tlab_geo_distance_n(prev_WP, lat, lng, dist, 2);
+    tlab_geo_bearing_n(prev_WP, lat, lng, bearing, 2);
+    Dist_currWP2UAV = dist[0];
+    rad_prevWP2UAV = bearing[0];
+    rad_prevWP2currWP = bearing[1];
 //    int16_t cd_prevWP2UAV = get_bearing_cd(prev_WP_loc, current_loc);
 //    int16_t cd_prevWP2currWP = get_bearing_cd(prev_WP_loc, next_WP_loc);
     float rad_WPline2UAV = rad_prevWP2UAV - rad_prevWP2currWP;
@@ -1114,7 +1180,7 @@ int32_t Plane::TLAB_Line_Trace_Controller()
         Vg_limited = v_g;
     }
     //added by Nishiduka 2018/4/19
-    if(g.TPARAM_switch_mo == 1){
+    if(tparam->switch_mo == 1){
     u_star = Vg_limited*calc_controller(state_UAV_y,state_UAV_GCRS);
     alpha=wrap_PI(state_UAV_phi-state_UAV_GCRS);
     if(alpha > alpha_max){
@@ -1123,7 +1189,7 @@ int32_t Plane::TLAB_Line_Trace_Controller()
             alpha = alpha_min;
         }
     L_conv = Vg_limited/(v_a*cosf(alpha));
-    }else if(g.TPARAM_switch_mo == 2){
+    }else if(tparam->switch_mo == 2){
     //added by Nishiduka 2018/4/19
     //y_set = g.TPARAM_y_set;
     //a_bottom = atanf(y_set);
@@ -1132,9 +1198,9 @@ int32_t Plane::TLAB_Line_Trace_Controller()
     //det_a = pow(a_above,2)/pow(a_bottom,2);
     sinc_kai = sinc(state_UAV_GCRS);
     //܂
-    det_a=g.TPARAM_control_a;
-    det_b=g.TPARAM_control_b;
-    det_p=g.TPARAM_control_p;
+    det_a=tparam->control_a;
+    det_b=tparam->control_b;
+    det_p=tparam->control_p;
     //u_star = -(((pow(det_a,2)*det_b*v_g)/(1+pow(det_b,2)*pow(state_UAV_y,2)))*atanf(det_b*state_UAV_y)*sinc(state_UAV_GCRS)+det_p*state_UAV_GCRS);
     u_star = -det_b*(state_UAV_GCRS+atanf(det_a*state_UAV_y)) - (det_a*v_g*sinf(state_UAV_GCRS))/(1+pow(det_a,2)*pow(state_UAV_y,2));
     alpha=wrap_PI(state_UAV_phi-state_UAV_GCRS);
@@ -1144,11 +1210,11 @@ int32_t Plane::TLAB_Line_Trace_Controller()
             alpha = alpha_min;
         }
     L_conv = Vg_limited/(v_a*cosf(alpha));
-    }else if(g.TPARAM_switch_mo == 3){
+    }else if(tparam->switch_mo == 3){
         //u_star = Vg_limited*calc_controller(state_UAV_y,state_UAV_phi);
-        det_a=g.TPARAM_control_a;
-        det_b=g.TPARAM_control_b;
-        det_p=g.TPARAM_control_p;
+        det_a=tparam->control_a;
+        det_b=tparam->control_b;
+        det_p=tparam->control_p;
         u_star = -(1/det_b)*(v_g*state_UAV_y+det_a*state_UAV_GCRS);
         alpha=wrap_PI(state_UAV_phi-state_UAV_GCRS);
         if(alpha > alpha_max){
@@ -1157,9 +1223,9 @@ int32_t Plane::TLAB_Line_Trace_Controller()
                     alpha = alpha_min;
                 }
         L_conv = Vg_limited/(v_a*cosf(alpha));
-    }else if(g.TPARAM_switch_mo == 4){
+    }else if(tparam->switch_mo == 4){
         //sinc_kai = sinc(state_UAV_GCRS);
-            L_1=g.TPARAM_L_1;
+            L_1=tparam->L_1;
             if (state_UAV_y<L_1){
                 eta=constrain_float(-state_UAV_GCRS-atanf(state_UAV_y/sqrtf(pow(L_1,2)-pow(state_UAV_y,2))),-M_PI/2,M_PI/2);
             }else if (state_UAV_y>=L_1){
@@ -1181,16 +1247,18 @@ int32_t Plane::TLAB_Line_Trace_Controller()
     //}else if(alpha < alpha_min){
     //    alpha = alpha_min;
     //}
-    u = constrain_float(L_conv/const_k*u_star,U_min*M_PI/180.0,U_max*M_PI/180.0) + g.TPARAM_servo_neutral*M_PI/180.0;
-    servo = static_cast<int32_t>(asinf(constrain_float(58.0f / 29.0f * sinf(u), -1.0f, 1.0f))*100.0f*180.0f/M_PI);
+    u = constrain_float(L_conv/const_k*u_star,tparam->U_min_rad,tparam->U_max_rad) + tparam->servo_neutral_rad;
+    servo = static_cast<int32_t>(tlab_asinf(constrain_float(58.0f / 29.0f * tlab_sinf(u), -1.0f, 1.0f))*100.0f*180.0f/M_PI);
     return servo;
 }
 int32_t Plane::TLAB_Circle_Trace_Controller(void)
 {
-    arg_r = get_distance(Target_Circle_Center,current_loc);
+    TLAB_GeoOrigin center;
+    tlab_geo_set_origin(center, Target_Circle_Center);
+    arg_r = tlab_geo_distance(center, current_loc);
     switch(calc_GCRS_flag){
     case 0:
-        theta = wrap_PI(static_cast<float>(get_bearing_cd(Target_Circle_Center,current_loc))*0.01f*M_PI/180.0f);
+        theta = wrap_PI(tlab_geo_bearing(center, current_loc));
         chi = wrap_PI(static_cast<float>(gps.ground_course_cd())*0.01*M_PI/180.0);
         break;
     default:
@@ -1202,7 +1270,7 @@ int32_t Plane::TLAB_Circle_Trace_Controller(void)
             chi = wrap_PI(static_cast<float>(get_bearing_cd(prev_POS,current_loc))*0.01f*M_PI/180.0f);
             mid_POS.lat = static_cast<int32_t>(prev_POS.lat + (current_loc.lat - prev_POS.lat)/2);
             mid_POS.lng = static_cast<int32_t>(prev_POS.lng + (current_loc.lng - prev_POS.lng)/2);
-            theta = wrap_PI(static_cast<float>(get_bearing_cd(Target_Circle_Center,mid_POS))*0.01f*M_PI/180.0f);
+            theta = wrap_PI(tlab_geo_bearing(center, mid_POS));
             diff_theta = wrap_PI(theta - prev_theta);
             Int_theta += diff_theta;
         }
@@ -1249,7 +1317,7 @@ int32_t Plane::TLAB_Circle_Trace_Controller(void)
     }
 */
     phi = wrap_PI(static_cast<float>(ahrs.yaw_sensor)*0.01f*M_PI/180.0f);
-    if(g.TPARAM_switch_mo == 1){
+    if(tparam->switch_mo == 1){
         u_star = Vg_limited*calc_controller(e_r,chi_r);
         alpha = wrap_PI(phi-chi);
             if(alpha > alpha_max){
@@ -1258,7 +1326,7 @@ int32_t Plane::TLAB_Circle_Trace_Controller(void)
                 alpha = alpha_min;
             }
             L_conv = Vg_limited/(v_a*cosf(alpha));
-    }else if(g.TPARAM_switch_mo == 2){
+    }else if(tparam->switch_mo == 2){
         //added by Nishiduka 2018/4/19
         //y_set = g.TPARAM_y_set;
         //a_bottom = atanf(y_set);
@@ -1267,9 +1335,9 @@ int32_t Plane::TLAB_Circle_Trace_Controller(void)
         //det_a = pow(a_above,2)/pow(a_bottom,2);
         //sinc_kai = sinc(state_UAV_GCRS);
         //܂
-        det_a=g.TPARAM_control_a;
-        det_b=g.TPARAM_control_b;
-        det_p=g.TPARAM_control_p;
+        det_a=tparam->control_a;
+        det_b=tparam->control_b;
+        det_p=tparam->control_p;
         //u_star = -(((pow(det_a,2)*det_b*v_g)/(1+pow(det_b,2)*pow(state_UAV_y,2)))*atanf(det_b*state_UAV_y)*sinc(state_UAV_GCRS)+det_p*state_UAV_GCRS);
         u_star = -det_b*(e_chi + atanf(det_a*e_r)) - (det_a*v_g*sinf(e_chi))/(1+pow(det_a,2)*pow(e_r,2));
         alpha = wrap_PI(phi-chi);
@@ -1279,11 +1347,11 @@ int32_t Plane::TLAB_Circle_Trace_Controller(void)
                 alpha = alpha_min;
             }
             L_conv = Vg_limited/(v_a*cosf(alpha));
-        }else if(g.TPARAM_switch_mo == 3){
+        }else if(tparam->switch_mo == 3){
             //u_star = Vg_limited*calc_controller(state_UAV_y,state_UAV_phi);
-            det_a=g.TPARAM_control_a;
-            det_b=g.TPARAM_control_b;
-            det_p=g.TPARAM_control_p;
+            det_a=tparam->control_a;
+            det_b=tparam->control_b;
+            det_p=tparam->control_p;
             u_star = -(1/det_b)*(v_g*e_r+det_a*e_chi);
             //alpha=wrap_PI(state_UAV_phi-state_UAV_GCRS);
             alpha = wrap_PI(phi-chi);
@@ -1293,8 +1361,8 @@ int32_t Plane::TLAB_Circle_Trace_Controller(void)
                     alpha = alpha_min;
                 }
                 L_conv = Vg_limited/(v_a*cosf(alpha));
-        }else if(g.TPARAM_switch_mo == 4){
-            L_1=g.TPARAM_L_1;
+        }else if(tparam->switch_mo == 4){
+            L_1=tparam->L_1;
              if (e_r<L_1){
                 eta=constrain_float(-e_chi-atanf(e_r/sqrtf(pow(L_1,2)-pow(e_r,2))),-M_PI/2,M_PI/2);
              }else if (e_r>=L_1){
@@ -1330,8 +1398,8 @@ int32_t Plane::TLAB_Circle_Trace_Controller(void)
         u = L_conv/const_k*u_star + Vg_limited*L_conv/(r_limited*const_k)*cosf(e_chi);
         break;
     }
-    u = constrain_float(u,U_min*M_PI/180.0,U_max*M_PI/180.0) + g.TPARAM_servo_neutral*M_PI/180.0;
-    servo = static_cast<int32_t>(asinf(constrain_float(58.0f / 29.0f * sinf(u), -1, 1))*100.0f*180.0f/M_PI);
+    u = constrain_float(u,tparam->U_min_rad,tparam->U_max_rad) + tparam->servo_neutral_rad;
+    servo = static_cast<int32_t>(tlab_asinf(constrain_float(58.0f / 29.0f * tlab_sinf(u), -1, 1))*100.0f*180.0f/M_PI);
     return servo;
 }
 
@@ -1382,7 +1450,7 @@ int32_t Plane::TLAB_Constant_Output(void){
 		servo = 0;
 		yet_init = true;
 	}
-	servo = static_cast<int32_t>(g.TPARAM_servo_neutral*100);  // [cdeg]
+	servo = static_cast<int32_t>(tparam->servo_neutral_cd);  // [cdeg]
 	return servo;
 }
 
@@ -1397,6 +1465,7 @@ void Plane::init_TLAB_2D_Trace_Controller(void){
 	// xyW̌_ʒuHP(I[g[hJnn_)ɐݒ(int32_t): ܓx,ox [1e-7*deg]
     Path_Origin.lat = prev_WP_loc.lat;
     Path_Origin.lng = prev_WP_loc.lng;
+    tlab_geo_set_origin(tlab_path_origin, Path_Origin);  // ox̃XP[͂1񂾂vZ
     // tCgv̐ݒ
     Flight_Plan = g.TPARAM_Flight_Plan;
 	// tB[hobNQC  Fx[3], Fchi[4][3]
@@ -1431,12 +1500,84 @@ void Plane::init_TLAB_2D_Trace_Controller(void){
 	Path_Mode = 0;  // ڕWoH̐ݒ
 	s = 0;  // oH [m] >= 0
 	zeta = 0;  // }ϐ >= 0
-	P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> x,y) [m]
-	P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> x,y) [m]
+	P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+	P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 	dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV
 	i_now_CMD = 0;
 	u_x = 0;
 	t_now = AP_HAL::micros64();  // ݂̎ [us]
+	// Flight_Plan 5: ~bVoHZOg𐶐, ŏ̃ZOgZbg
+	if (Flight_Plan == 5) {
+		TLAB_compile_path_segments();
+	}
+	reset_TLAB_metrics();
+}
+
+
+/*
+ * "Ǐ]\̕]wW̃Zbg"
+ * Tv: RMS yF, ő |chiF|, RMS e_m, T[{OaԂ̐ώZl0ɖ߂
+*/
+void Plane::reset_TLAB_metrics(void){
+	memset(&tlab_metrics, 0, sizeof(tlab_metrics));
+	tlab_metrics.start_us = AP_HAL::micros64();
+	tlab_metrics.gain_hash = TLAB_gain_hash();
+}
+
+
+/*
+ * "tB[hobNQC̃nbVl"
+ * Tv: ݂̃QC̑g 32bit FNV-1a ŃnbV(PTRK Oɏo)
+ *       : Fx[3], Fchi[4][3], LQR_f1~f4, xPD(d1, d2, kp0, kd0, kp1, kd1), F11~F42,
+ *             c_alt, cha_pow (int32), LȃQCe[u id, n_rules, n_states, n_premise, z, F
+ *             (e[u͎gpĂ͈͂̂. R[h̃e[ugƂ id = 0 ̂)
+ *       QC̑g͏ɓlɂȂ邽, ItC̃QCœKŕ]ʂ̃L[ƂĎg
+ *       p[^e[u؂ւƂ swap_TLAB_params() ōČvZ
+*/
+static uint32_t tlab_fnv1a(uint32_t hash, const void *data, uint16_t len){
+	const uint8_t *b = (const uint8_t *)data;
+	for (uint16_t i = 0; i < len; i++) {
+		hash ^= b[i];
+		hash *= 16777619UL;
+	}
+	return hash;
+}
+
+uint32_t Plane::TLAB_gain_hash(void){
+	const float gains[] = {
+		Fx[0], Fx[1], Fx[2],
+		Fchi[0][0], Fchi[0][1], Fchi[0][2],
+		Fchi[1][0], Fchi[1][1], Fchi[1][2],
+		Fchi[2][0], Fchi[2][1], Fchi[2][2],
+		Fchi[3][0], Fchi[3][1], Fchi[3][2],
+		g.TPARAM_LQR_f1, g.TPARAM_LQR_f2, g.TPARAM_LQR_f3, g.TPARAM_LQR_f4,
+		g.TPARAM_pdc_height_d1_Th, g.TPARAM_pdc_height_d2_Th,
+		g.TPARAM_height_kp0_Th, g.TPARAM_height_kd0_Th,
+		g.TPARAM_height_kp1_Th, g.TPARAM_height_kd1_Th,
+		g.TPARAM_F11, g.TPARAM_F12, g.TPARAM_F21, g.TPARAM_F22,
+		g.TPARAM_F31, g.TPARAM_F32, g.TPARAM_F41, g.TPARAM_F42
+	};
+	uint32_t hash = tlab_fnv1a(2166136261UL, gains, sizeof(gains));
+
+	const int32_t alt_select[2] = {
+		(tparam != nullptr) ? tparam->c_alt : g.TPARAM_c_alt,
+		(tparam != nullptr) ? tparam->cha_pow : g.TPARAM_cha_pow
+	};
+	hash = tlab_fnv1a(hash, alt_select, sizeof(alt_select));
+
+	if (tlab_gain == nullptr) {
+		const uint16_t id = 0;
+		return tlab_fnv1a(hash, &id, sizeof(id));
+	}
+	hash = tlab_fnv1a(hash, &tlab_gain->id, sizeof(tlab_gain->id));
+	hash = tlab_fnv1a(hash, &tlab_gain->n_rules, sizeof(tlab_gain->n_rules));
+	hash = tlab_fnv1a(hash, &tlab_gain->n_states, sizeof(tlab_gain->n_states));
+	hash = tlab_fnv1a(hash, &tlab_gain->n_premise, sizeof(tlab_gain->n_premise));
+	hash = tlab_fnv1a(hash, tlab_gain->z, sizeof(tlab_gain->z[0])*tlab_gain->n_premise);
+	for (uint8_t i = 0; i < tlab_gain->n_rules; i++) {
+		hash = tlab_fnv1a(hash, tlab_gain->F[i], sizeof(float)*tlab_gain->n_states);
+	}
+	return hash;
 }
 
 
@@ -1456,7 +1597,6 @@ void Plane::TLAB_generate_2D_Path(void){
 	}
 	*/
 
-	float Px, Py;  // \ Vector2f x, yu邽߂Ɏgp
 	Location WP0;  // ڕWoH̏ʒuݒ肷邽߂̃[Jϐ
 	// tCgvw肷
 	switch (Flight_Plan) {
@@ -1468,16 +1608,8 @@ void Plane::TLAB_generate_2D_Path(void){
 		if (zeta < 0.1 && i_now_CMD != i_prev_CMD) {
 			// oHXV(Ȃ̂Œ`)
 			dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV
-			P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-			Px = P0.y;
-			Py = P0.x;
-			P0.x = Px;
-			P0.y = Py;
-			P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-			Px = P1.y;
-			Py = P1.x;
-			P1.x = Px;
-			P1.y = Py;
+			P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+			P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 		}
 		// WPaɓB,WPVɃZbgꂽƂ
 		else if (zeta >= 0.1 && i_now_CMD != i_prev_CMD) {
@@ -1496,25 +1628,13 @@ void Plane::TLAB_generate_2D_Path(void){
 				WP0.lat = g.TPARAM_Path_Origin_lat;  // ڕWoH̏ʒu(WP0) ܓx [1e-7*deg]
 				WP0.lng = g.TPARAM_Path_Origin_lng;  // ڕWoH̏ʒu(WP0) ox [1e-7*deg]
 				dist_WPs = get_distance(WP0, next_WP_loc);  // 2WPԂ̋ [m]XV
-				P0 = location_diff(Path_Origin, WP0);  // P0MPŐݒ肵ʒuɃZbg: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, WP0);  // P0MPŐݒ肵ʒuɃZbg: ڕWoHS̕ψ(x: , y: k) [m]
 			}
 			else {
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
 			}
-			P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-			Px = P1.y;
-			Py = P1.x;
-			P1.x = Px;
-			P1.y = Py;
+			P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 		}
 		break;
 	// Mode 1: WP0 -()-> WP1 -(~oHEE)-> WP2
@@ -1529,21 +1649,13 @@ void Plane::TLAB_generate_2D_Path(void){
 				WP0.lat = g.TPARAM_Path_Origin_lat;  // ڕWoH̏ʒu(WP0) ܓx [1e-7*deg]
 				WP0.lng = g.TPARAM_Path_Origin_lng;  // ڕWoH̏ʒu(WP0) ox [1e-7*deg]
 				dist_WPs = get_distance(WP0, next_WP_loc);  // 2WPԂ̋ [m]XV
-				P0 = location_diff(Path_Origin, WP0);  // P0MPŐݒ肵ʒuɃZbg: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, WP0);  // P0MPŐݒ肵ʒuɃZbg: ڕWoHS̕ψ(x: , y: k) [m]
 				//P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
 				//Px = P0.y;
 				//Py = P0.x;
 				//P0.x = Px;
 				//P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 			}
 			// WPaɓB,WPVɃZbgꂽƂ
 			else if (zeta >= 0.1 && i_now_CMD != i_prev_CMD) {
@@ -1558,16 +1670,8 @@ void Plane::TLAB_generate_2D_Path(void){
 				change_path_flag = false;
 				// P0, P1̍XV
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV ---gȂ
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 				Path_Mode = 5;  // ~oH E񃂁[hɃZbg
 			}
 		}
@@ -1594,16 +1698,8 @@ void Plane::TLAB_generate_2D_Path(void){
 				//P0.x = Px;
 				//P0.y = Py;
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 			}
 			// WPaɓB,WPVɃZbgꂽƂ
 			else if (zeta >= 0.1 && i_now_CMD != i_prev_CMD) {
@@ -1618,16 +1714,8 @@ void Plane::TLAB_generate_2D_Path(void){
 				change_path_flag = false;
 				// P0, P1̍XV
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV ---gȂ
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 				if (i_now_CMD == 3) {
 					Path_Mode = 6;  // T[WȐi8̎joH[hɃZbg
 				}
@@ -1647,16 +1735,8 @@ void Plane::TLAB_generate_2D_Path(void){
 				change_path_flag = false;
 				// P0, P1̍XV
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV ---gȂ
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 				Path_Mode = 0;  // oH[hɃZbg
 			}
 		}
@@ -1678,16 +1758,8 @@ void Plane::TLAB_generate_2D_Path(void){
 				//P0.x = Px;
 				//P0.y = Py;
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 			}
 			// WPaɓB,WPVɃZbgꂽƂ
 			else if (zeta >= 0.1 && i_now_CMD != i_prev_CMD) {
@@ -1702,19 +1774,11 @@ void Plane::TLAB_generate_2D_Path(void){
 				change_path_flag = false;
 				// P0, P1̍XV
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV ---gȂ
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 				if (i_now_CMD == 3) {
-					P1.x -= g.TPARAM_r;
-					P1.y -= g.TPARAM_r;
+					P1.x -= tparam->r;
+					P1.y -= tparam->r;
 					Path_Mode = 3;  // T[WȐidʑ}[NjoH[hɃZbg
 				}
 			}
@@ -1733,16 +1797,8 @@ void Plane::TLAB_generate_2D_Path(void){
 				change_path_flag = false;
 				// P0, P1̍XV
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV ---gȂ
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 				Path_Mode = 0;  // oH[hɃZbg
 			}
 		}
@@ -1759,21 +1815,13 @@ void Plane::TLAB_generate_2D_Path(void){
 				WP0.lat = g.TPARAM_Path_Origin_lat;  // ڕWoH̏ʒu(WP0) ܓx [1e-7*deg]
 				WP0.lng = g.TPARAM_Path_Origin_lng;  // ڕWoH̏ʒu(WP0) ox [1e-7*deg]
 				dist_WPs = get_distance(WP0, next_WP_loc);  // 2WPԂ̋ [m]XV
-				P0 = location_diff(Path_Origin, WP0);  // P0MPŐݒ肵ʒuɃZbg: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, WP0);  // P0MPŐݒ肵ʒuɃZbg: ڕWoHS̕ψ(x: , y: k) [m]
 				//P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
 				//Px = P0.y;
 				//Py = P0.x;
 				//P0.x = Px;
 				//P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 			}
 			// WPaɓB,WPVɃZbgꂽƂ
 			else if (zeta >= 0.1 && i_now_CMD != i_prev_CMD) {
@@ -1788,16 +1836,8 @@ void Plane::TLAB_generate_2D_Path(void){
 				change_path_flag = false;
 				// P0, P1̍XV
 				dist_WPs = get_distance(prev_WP_loc, next_WP_loc);  // 2WPԂ̋ [m]XV ---gȂ
-				P0 = location_diff(Path_Origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P0.y;
-				Py = P0.x;
-				P0.x = Px;
-				P0.y = Py;
-				P1 = location_diff(Path_Origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(N.E <-> y,x) [m]
-				Px = P1.y;
-				Py = P1.x;
-				P1.x = Px;
-				P1.y = Py;
+				P0 = tlab_geo_xy(tlab_path_origin, prev_WP_loc);  // P0XV: ڕWoHS̕ψ(x: , y: k) [m]
+				P1 = tlab_geo_xy(tlab_path_origin, next_WP_loc);  // P1XV: ڕWoHS̕ψ(x: , y: k) [m]
 				Path_Mode = 4;  // ~oH 񃂁[hɃZbg
 			}
 		}
@@ -1806,10 +1846,24 @@ void Plane::TLAB_generate_2D_Path(void){
 			// oH̐؂ւ͂Ȃ  -> ~oH񂵑
 		}
 		break;
+	// Mode 5: ~bV琶oHZOgɒǏ]
+	// : NAV_WAYPOINT, ~: NAV_LOITER_TURNS / NAV_LOITER_UNLIM, T[WȐ: NAV_LOITER_TIME (TLAB_PathSegments.cpp Q)
+	case 5:
+		// oH s ZOǧoHɒB玟̃ZOg(ߕ s ͈p)
+		while (tlab_seg_idx + 1 < tlab_seg_count &&
+			   tlab_seg[tlab_seg_idx].length > 0 &&
+			   s >= tlab_seg[tlab_seg_idx].length) {
+			s -= tlab_seg[tlab_seg_idx].length;
+			zeta_prev = 0;  // zeta ̏uԂ dot_zeta傫Ȃ̂h
+			TLAB_set_path_segment(tlab_seg_idx + 1);
+		}
+		break;
 	}  // switch(Flight_Plan)̏I
 
-	float dPdzeta = 0;
 	// oH̎ނw肷
+	float k_den;  // T[WȐ̋ȗ̕ (powf(x, 1.5f) ̑ x*sqrtf(x) ŌvZ)
+	// T[WȐ̔a [m]: Flight_Plan 5 ł̓ZOg̒lg(s TP2D_R ςĂoHȂ悤)
+	float r_liss = (Flight_Plan == 5 && tlab_seg_count > 0) ? tlab_seg[tlab_seg_idx].r : tparam->r;
 	switch (Path_Mode) {
 	// Mode 0: 2_WP(P0, P1)Œ`钼oH
 	case 0:
@@ -1817,7 +1871,7 @@ void Plane::TLAB_generate_2D_Path(void){
 		dot_zeta = (zeta - zeta_prev)/dt;  // gȂ
 		x_d = (1 - zeta)*P0.x + zeta*P1.x;  // [m] x,y ۂƂ͋tӖĂ邱Ƃɒ
 		y_d = (1 - zeta)*P0.y + zeta*P1.y;  // [m]
-		chi_d = - atan2f((P1.y - P0.y), (P1.x - P0.x));  // [rad]: (-PI ~ PI)
+		chi_d = - tlab_atan2f((P1.y - P0.y), (P1.x - P0.x));  // [rad]: (-PI ~ PI)
 		dot_chi_d = 0;
 		kappa = 0;
 		break;
@@ -1825,9 +1879,9 @@ void Plane::TLAB_generate_2D_Path(void){
 	case 1:
 		zeta = s/dist_WPs*2;
 		dot_zeta = (zeta - zeta_prev)/dt;  // gȂ
-		x_d = dist_WPs/2*cosf(zeta) + (P0.x + P1.x)/2;
-		y_d = dist_WPs/2*sinf(zeta) + (P0.y + P1.y)/2;
-		chi_d = atan2f(cosf(zeta), sinf(zeta));
+		x_d = dist_WPs/2*tlab_cosf(zeta) + (P0.x + P1.x)/2;
+		y_d = dist_WPs/2*tlab_sinf(zeta) + (P0.y + P1.y)/2;
+		chi_d = tlab_atan2f(tlab_cosf(zeta), tlab_sinf(zeta));
 		dot_chi_d = - dot_zeta;
 		kappa = 2/dist_WPs;
 		break;
@@ -1835,70 +1889,70 @@ void Plane::TLAB_generate_2D_Path(void){
 	case 2:
 		zeta = s/dist_WPs*2;
 		dot_zeta = (zeta - zeta_prev)/dt;  // gȂ
-		x_d = dist_WPs/2*cosf(-zeta) + (P0.x + P1.x)/2;
-		y_d = dist_WPs/2*sinf(-zeta) + (P0.y + P1.y)/2;
-		chi_d = atan2f(cosf(zeta), -sinf(zeta));
+		x_d = dist_WPs/2*tlab_cosf(-zeta) + (P0.x + P1.x)/2;
+		y_d = dist_WPs/2*tlab_sinf(-zeta) + (P0.y + P1.y)/2;
+		chi_d = tlab_atan2f(tlab_cosf(zeta), -tlab_sinf(zeta));
 		dot_chi_d = dot_zeta;
 		kappa = 2/dist_WPs;
 		break;
 	// Mode 3: 1_WP(P1)ƔarŒ`郊T[WȐoH(dʑ}[Nver.) : n_
 	case 3:
-		// s  dPdzeta 琔lvZzeta߂
-		while (1) {
-			dPdzeta = g.TPARAM_r*sqrt((25*powf(sinf(5*g.TPARAM_dzeta*i_zeta), 2) + 36*pow(sinf(6*g.TPARAM_dzeta*i_zeta), 2)));
-			s_calc += dPdzeta*g.TPARAM_dzeta;
-			if (s_calc >= s) {
-				zeta = i_zeta*g.TPARAM_dzeta;
-				break;
-			}
-			i_zeta ++;
-		}
+		// s oHe[uzeta߂
+		zeta = TLAB_lissajous_zeta(TLAB_LISS_UEC, s, r_liss);
 		dot_zeta = (zeta - zeta_prev)/dt;
-		x_d = - g.TPARAM_r*cosf(5.f*zeta) + P1.x;
-		y_d = g.TPARAM_r*cosf(6.f*zeta) + P1.y;
-		chi_d = atan2f(6.f/5.f*sinf(6.f*zeta), sinf(5.f*zeta));
-		dot_chi_d = - 30*dot_zeta*(sinf(11*zeta) - 11*sinf(zeta))/(25*cosf(10*zeta) + 36*cosf(12*zeta) - 61.f);
-		kappa = (15*fabsf(11.f*sinf(zeta) - sinf(11*zeta))) / (g.TPARAM_r*powf((25*powf(sinf(5*zeta) , 2) + 36*powf(sinf(6*zeta) , 2)) , 1.5f));
+		x_d = - r_liss*tlab_cosf(5.f*zeta) + P1.x;
+		y_d = r_liss*tlab_cosf(6.f*zeta) + P1.y;
+		chi_d = tlab_atan2f(6.f/5.f*tlab_sinf(6.f*zeta), tlab_sinf(5.f*zeta));
+		dot_chi_d = - 30*dot_zeta*(tlab_sinf(11*zeta) - 11*tlab_sinf(zeta))/(25*tlab_cosf(10*zeta) + 36*tlab_cosf(12*zeta) - 61.f);
+		k_den = 25*sq(tlab_sinf(5*zeta)) + 36*sq(tlab_sinf(6*zeta));
+		kappa = (15*fabsf(11.f*tlab_sinf(zeta) - tlab_sinf(11*zeta))) / (r_liss*k_den*sqrtf(k_den));
 		break;
 	// Mode 4: 1_WP(P1)ƔarŒ`~oH(): ʑ +PI
 	case 4:
-		zeta = s/g.TPARAM_r;
+		zeta = s*tparam->r_inv;
 		dot_zeta = (zeta - zeta_prev)/dt;
-		x_d = - g.TPARAM_r*cosf(zeta) + P1.x;
-		y_d = - g.TPARAM_r*sinf(zeta) + P1.y;
-		chi_d = atan2f(cosf(zeta), sinf(zeta));
+		x_d = - tparam->r*tlab_cosf(zeta) + P1.x;
+		y_d = - tparam->r*tlab_sinf(zeta) + P1.y;
+		chi_d = tlab_atan2f(tlab_cosf(zeta), tlab_sinf(zeta));
 		dot_chi_d = - dot_zeta;
-		kappa = 1.f/g.TPARAM_r;
+		kappa = tparam->r_inv;
 		break;
 	// Mode 5: 1_WP(P1)ƔarŒ`~oH(E): ʑ +PI
 	case 5:
-		zeta = s/g.TPARAM_r;
+		zeta = s*tparam->r_inv;
 		dot_zeta = (zeta - zeta_prev)/dt;
-		x_d = - g.TPARAM_r*cosf(zeta) + P1.x;
-		y_d = g.TPARAM_r*sinf(zeta) + P1.y;
-		chi_d = atan2f(-cosf(zeta), sinf(zeta));
+		x_d = - tparam->r*tlab_cosf(zeta) + P1.x;
+		y_d = tparam->r*tlab_sinf(zeta) + P1.y;
+		chi_d = tlab_atan2f(-tlab_cosf(zeta), tlab_sinf(zeta));
 		dot_chi_d = dot_zeta;
-		kappa = 1.f/g.TPARAM_r;
+		kappa = tparam->r_inv;
 		break;
 	// Mode 6: 1_WP(P1)ƔarŒ`郊T[WȐoH(8̎ver.) : xNg͉EɌ
 	case 6:
-		// s  dPdzeta 琔lvZzeta߂
-		while (1) {
-			dPdzeta = g.TPARAM_r*sqrt((25*powf(sinf(5*g.TPARAM_dzeta*i_zeta), 2) + 36*pow(sinf(6*g.TPARAM_dzeta*i_zeta), 2)));
-			s_calc += dPdzeta*g.TPARAM_dzeta;
-			if (s_calc >= s) {
-				zeta = i_zeta*g.TPARAM_dzeta;
-				break;
-			}
-			i_zeta ++;
-		}
+		// s oHe[uzeta߂
+		// ȑO͓dʑ}[N |dP/dzeta| ŐϕĂ, 8̎̌oH zeta ΉĂȂ
+		zeta = TLAB_lissajous_zeta(TLAB_LISS_FIG8, s, r_liss);
+		dot_zeta = (zeta - zeta_prev)/dt;
+		x_d = 2*r_liss*tlab_sinf(zeta) + P1.x;
+		y_d = r_liss*tlab_sinf(2*zeta) + P1.y;
+		chi_d = tlab_atan2f(- tlab_cosf(2*zeta), tlab_cosf(zeta));
+		dot_chi_d = - (dot_zeta*tlab_sinf(zeta)*(2*sq(tlab_sinf(zeta)) - 3))/(4*sq(sq(tlab_sinf(zeta))) - 5*sq(tlab_sinf(zeta)) + 2);
+		k_den = 4*sq(sq(tlab_cosf(zeta))) - 3*sq(tlab_cosf(zeta)) + 1;
+		kappa = - (fabsf(tlab_sinf(zeta))*(2*sq(tlab_sinf(zeta)) - 3))/(2*r_liss*k_den*sqrtf(k_den));
+		break;
+	// Mode 7: S(P1), a, ʑ, ]oHZOgŎw肷~
+	case 7: {
+		const TLAB_Path_Segment &seg = tlab_seg[tlab_seg_idx];
+		zeta = s/seg.r;
 		dot_zeta = (zeta - zeta_prev)/dt;
-		x_d = 2*g.TPARAM_r*sinf(zeta) + P1.x;
-		y_d = g.TPARAM_r*sinf(2*zeta) + P1.y;
-		chi_d = atan2f(- cosf(2*zeta), cosf(zeta));
-		dot_chi_d = - (dot_zeta*sinf(zeta)*(2*powf(sinf(zeta), 2) - 3))/(4*powf(sinf(zeta), 4) - 5*powf(sinf(zeta), 2) + 2);
-		kappa = - (fabsf(sinf(zeta))*(2*powf(sinf(zeta) , 2) - 3))/(2*g.TPARAM_r*powf((4*powf(cosf(zeta) , 4) - 3*powf(cosf(zeta) , 2) + 1) , 1.5f));
+		float theta = seg.phase0 + seg.dir*zeta;  // S猩ڕW_̕ [rad]
+		x_d = seg.r*tlab_cosf(theta) + P1.x;
+		y_d = seg.r*tlab_sinf(theta) + P1.y;
+		chi_d = tlab_atan2f(- seg.dir*tlab_cosf(theta), - seg.dir*tlab_sinf(theta));
+		dot_chi_d = - seg.dir*dot_zeta;
+		kappa = 1/seg.r;
 		break;
+	}
 	default:
 		zeta = 0;
 		break;
@@ -1924,9 +1978,9 @@ int32_t Plane::TLAB_2D_Trace_Controller(void){
 	uint64_t t_prev = t_now;  // O̎ [us]
 	t_now = AP_HAL::micros64();  // ݂̎ [us]
 	dt = (t_now - t_prev)*1.e-6f;  // TvOԊԊu [s]
-	Vector2f xyI = location_diff(Path_Origin, current_loc);  // ݒn_: ڕWoHS̕ψ(N.E <-> y,x) [m]
-	xI = xyI.y;  // xW(ܓx) [m]
-	yI = xyI.x;  // yW(ox) [m]
+	Vector2f xyI = tlab_geo_xy(tlab_path_origin, current_loc);  // ݒn_: ڕWoHS̕ψ(x: , y: k) [m]
+	xI = xyI.x;  // xW(ox) [m]
+	yI = xyI.y;  // yW(ܓx) [m]
 	psi = wrap_2PI(ahrs.yaw - M_PI/2);  // [p(@ʊp) [rad] (0 ~ 2PI)
 	chi = wrap_2PI(gps.ground_course()*M_PI/180.0f - M_PI/2);  // qHp [rad]: (0 ~ 2PI)
 	v_g = gps.ground_speed();  // Βnx̑傫 [m/s]
@@ -1937,16 +1991,20 @@ int32_t Plane::TLAB_2D_Trace_Controller(void){
 	// Wn{I}ZEtlWn{F}ւ̕ϊ
 	float e_xI = x_d - xI;  // W x ̐΍ [m]
 	float e_yI = y_d - yI;  // W y ̐΍ [m]
-	xF = - cosf(chi_d)*e_xI + sinf(chi_d)*e_yI;  // [m]
-	yF = - sinf(chi_d)*e_xI - cosf(chi_d)*e_yI;  // [m]
+	float sin_chi_d, cos_chi_d;
+	tlab_sincosf(chi_d, sin_chi_d, cos_chi_d);
+	xF = - cos_chi_d*e_xI + sin_chi_d*e_yI;  // [m]
+	yF = - sin_chi_d*e_xI - cos_chi_d*e_yI;  // [m]
 	chiF = wrap_PI(chi_d - chi);  // [rad]: (-PI ~ PI)
-	float X[3] = {xF, yF, chiF};  // ԕϐxNg
+	TLAB_Vector<3> X = {{xF, yF, chiF}};  // ԕϐxNg
+
+	// ]wW̐ώZ
+	tlab_metrics.n_2D++;
+	tlab_metrics.sum_yF2 += yF*yF;
+	tlab_metrics.max_abs_chiF = MAX(tlab_metrics.max_abs_chiF, fabsf(chiF));
 
 	//  u_x ̌vZ
-	u_x_calc = 0;  // vZp u_x ̏
-	for (int i = 0; i < 3; i++) {
-		u_x_calc -= Fx[i]*X[i];
-	}
+	u_x_calc = - Fx.dot(X);
 	/*
 	// u_x ̃t@WB͈͏ u_x_max œ͒lJbg
 	if (u_x_calc > u_x_max) {
@@ -1963,8 +2021,10 @@ int32_t Plane::TLAB_2D_Trace_Controller(void){
 
 	// o[Vbv֐̌vZ
 	// `
-	float z1 = (v_g*cosf(chiF) + u_x)*kappa;  // Ws̔` 1
-	float z2 = v_g*sinf(chiF)/chiF;  // Ws̔`2
+	float sin_chiF, cos_chiF;
+	tlab_sincosf(chiF, sin_chiF, cos_chiF);
+	float z1 = (v_g*cos_chiF + u_x)*kappa;  // Ws̔` 1
+	float z2 = v_g*sin_chiF/chiF;  // Ws̔`2
 	// K1, K2, M1, M2 ̌vZ
 	if (chiF == 0) {
 		// 0΍
@@ -2010,15 +2070,19 @@ int32_t Plane::TLAB_2D_Trace_Controller(void){
 	u_chi = u_chi_calc;
 
 	// oH  s ̍XV(lϕ)
-	ds = u_x + v_g*cosf(chiF);  // ڕW_ P ̈ړx [m/s]
+	ds = u_x + v_g*cos_chiF;  // ڕW_ P ̈ړx [m/s]
 	s += ds*dt;  // oH̍XV [m]
 
 	// u_chi [rad/s] Rg[o[px bar_angle, T[{[^[px servo [cdeg] ֕ϊ
-    d_angle = static_cast<int32_t>(1/k_prop_const*v_g/v_a/cosf(chi - psi)*(-u_chi + dot_chi_d)*100.0f*180.0f/M_PI);  // [cdeg]
-    bar_angle = d_angle + g.TPARAM_servo_neutral*100;  // Rg[o[px [cdeg]
+    d_angle = static_cast<int32_t>(1/k_prop_const*v_g/v_a/tlab_cosf(chi - psi)*(-u_chi + dot_chi_d)*100.0f*180.0f/M_PI);  // [cdeg]
+    bar_angle = d_angle + tparam->servo_neutral_cd;  // Rg[o[px [cdeg]
     // Changed by Kaito Yamamoto 2021.08.11.
     u = bar_angle/100.f*M_PI/180.f;  // [cdeg] --> [rad]
-    servo = static_cast<int32_t>(asinf(constrain_float(58.0f / 29.0f * sinf(u), -1, 1))*100.0f*180.0f/M_PI);  // T[{[^[px [cdeg]
+    float sin_servo = 58.0f / 29.0f * tlab_sinf(u);
+    if (fabsf(sin_servo) > 1.0f) {
+        tlab_metrics.servo_sat_time += dt;  // T[{pxOa
+    }
+    servo = static_cast<int32_t>(tlab_asinf(constrain_float(sin_servo, -1, 1))*100.0f*180.0f/M_PI);  // T[{[^[px [cdeg]
     return servo;
 }
 
@@ -527,7 +527,7 @@ void Plane::Log_Write_PPG5()
     struct log_PPG5 pkt = {
             LOG_PACKET_HEADER_INIT(LOG_PPG5_MSG),
             time_us         : AP_HAL::micros64(),
-            dz_f            : dz_f,
+            dz_f            : dz,
             gps_dh          : gps_dh,
             gps_dpitch		: gps_dpitch
     };
@@ -688,6 +688,126 @@ void Plane::Log_Write_PPG_2D_4()
     DataFlash.WriteBlock(&pkt, sizeof(pkt));
 }
 
+// Tracking metrics accumulated since the 2D trace controller was
+// initialised. The last record of a flight is the summary of the run.
+// Written once a second when NTUN logging is enabled.
+struct PACKED log_PPG_Metrics {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float elapsed;
+    uint32_t n_2D;
+    float yF_rms;
+    float chiF_max;
+    float e_m_rms;
+    float sat_time;
+    uint32_t gain_hash;
+};
+
+void Plane::Log_Write_PPG_Metrics()
+{
+    uint64_t now = AP_HAL::micros64();
+    struct log_PPG_Metrics pkt = {
+            LOG_PACKET_HEADER_INIT(LOG_PPG_METRICS_MSG),
+            time_us		: now,
+            elapsed		: (now - tlab_metrics.start_us)*1.0e-6f,
+            n_2D		: tlab_metrics.n_2D,
+            yF_rms		: tlab_metrics.n_2D > 0 ? (float)sqrt(tlab_metrics.sum_yF2/tlab_metrics.n_2D) : 0.0f,
+            chiF_max	: tlab_metrics.max_abs_chiF,
+            e_m_rms		: tlab_metrics.n_alt > 0 ? (float)sqrt(tlab_metrics.sum_e_m2/tlab_metrics.n_alt) : 0.0f,
+            sat_time	: (float)tlab_metrics.servo_sat_time,
+            gain_hash	: tlab_metrics.gain_hash
+    };
+    DataFlash.WriteBlock(&pkt, sizeof(pkt));
+}
+
+// Time spent in each phase of setup(), and when the pre-arm checks
+// first passed. Written at the start of every log and again once the
+// vehicle becomes armable.
+struct PACKED log_PPG_Boot {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint32_t defaults_us;
+    uint32_t notify_us;
+    uint32_t rssi_us;
+    uint32_t init_us;
+    uint32_t tlab_us;
+    uint32_t sched_us;
+    uint32_t setup_ms;
+    uint32_t armable_ms;
+};
+
+void Plane::Log_Write_PPG_Boot()
+{
+    struct log_PPG_Boot pkt = {
+            LOG_PACKET_HEADER_INIT(LOG_PPG_BOOT_MSG),
+            time_us		: AP_HAL::micros64(),
+            defaults_us	: tlab_boot.defaults_us,
+            notify_us	: tlab_boot.notify_us,
+            rssi_us		: tlab_boot.rssi_us,
+            init_us		: tlab_boot.init_us,
+            tlab_us		: tlab_boot.tlab_us,
+            sched_us	: tlab_boot.sched_us,
+            setup_ms	: tlab_boot.setup_ms,
+            armable_ms	: tlab_boot.armable_ms
+    };
+    DataFlash.WriteBlock(&pkt, sizeof(pkt));
+}
+
+// Innovation statistics of the altitude and pitch rate filters over the
+// last second (TLAB_AlphaBeta.h). Written once a second with PTRK.
+struct PACKED log_PPG_Filter {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint32_t n_z;
+    float z_rms;
+    float z_max;
+    uint32_t n_pitch;
+    float pitch_rms;
+    float pitch_max;
+    float dz;
+    float dpitch;
+};
+
+void Plane::Log_Write_PPG_Filter()
+{
+    struct log_PPG_Filter pkt = {
+            LOG_PACKET_HEADER_INIT(LOG_PPG_FILTER_MSG),
+            time_us		: AP_HAL::micros64(),
+            n_z			: tlab_ab_z.get_count(),
+            z_rms		: tlab_ab_z.get_innovation_rms(),
+            z_max		: tlab_ab_z.get_innovation_max(),
+            n_pitch		: tlab_ab_pitch.get_count(),
+            pitch_rms	: tlab_ab_pitch.get_innovation_rms(),
+            pitch_max	: tlab_ab_pitch.get_innovation_max(),
+            dz			: tlab_ab_z.get_rate(),
+            dpitch		: tlab_ab_pitch.get_rate()
+    };
+    DataFlash.WriteBlock(&pkt, sizeof(pkt));
+    tlab_ab_z.reset_stats();
+    tlab_ab_pitch.reset_stats();
+}
+
+// Hash of the stored mission in its MISSION_ITEM_INT form, see
+// TLAB_MissionCache.cpp. Written after each cache rebuild and at the
+// start of every log.
+struct PACKED log_PPG_Mission_Hash {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint16_t num_cmds;
+    uint32_t hash;
+};
+
+void Plane::Log_Write_PPG_Mission_Hash()
+{
+    struct log_PPG_Mission_Hash pkt = {
+            LOG_PACKET_HEADER_INIT(LOG_PPG_MISSION_HASH_MSG),
+            time_us		: AP_HAL::micros64(),
+            num_cmds	: tlab_mission_num_commands,
+            hash		: tlab_mission_hash
+    };
+    DataFlash.WriteBlock(&pkt, sizeof(pkt));
+}
+
 struct PACKED log_Status {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -917,6 +1037,14 @@ const struct LogStructure Plane::log_structure[] = {
     // Added by Kaito Yamamoto 2021.08.05.
     { LOG_PPG_2D_4_MSG, sizeof(log_PPG_2D_4),
       "P2D4", "Hfiiiiffff", "CMDid, ux_cal, pWPlt, pWPlg, nWPlt, nWPlg, P0x, P0y, P1x, P1y" },
+    { LOG_PPG_METRICS_MSG, sizeof(log_PPG_Metrics),
+      "PTRK", "QfIffffI", "TimeUS,T,N,yF_rms,chiF_max,e_m_rms,sat_T,GHash" },
+    { LOG_PPG_BOOT_MSG, sizeof(log_PPG_Boot),
+      "PBOT", "QIIIIIIII", "TimeUS,DefUS,NtfyUS,RssiUS,InitUS,TLABUS,SchedUS,SetupMS,ArmMS" },
+    { LOG_PPG_FILTER_MSG, sizeof(log_PPG_Filter),
+      "PABF", "QIffIffff", "TimeUS,NZ,InnZ,MaxZ,NP,InnP,MaxP,dZ,dP" },
+    { LOG_PPG_MISSION_HASH_MSG, sizeof(log_PPG_Mission_Hash),
+      "PMSH", "QHI", "TimeUS,NCmd,Hash" },
 };
 
 #if CLI_ENABLED == ENABLED
@@ -939,6 +1067,10 @@ void Plane::Log_Write_Vehicle_Startup_Messages()
 {
     // only 200(?) bytes are guaranteed by DataFlash
     Log_Write_Startup(TYPE_GROUNDSTART_MSG);
+    Log_Write_PPG_Boot();
+    if (tlab_mission_valid) {
+        Log_Write_PPG_Mission_Hash();
+    }
     DataFlash.Log_Write_Mode(control_mode);
     DataFlash.Log_Write_Rally(rally);
 }
@@ -1740,8 +1740,8 @@ const AP_Param::Info Plane::var_info[] = {
 
     // @Param: TPARAM_Flight_Plan
     // @DisplayName: TPARAM_Flight_Plan
-    // @Description: TLab parameter
-    // @Range: 0 3
+    // @Description: TLab parameter. 5 builds the path from the mission: waypoints are lines, LOITER_TURNS/LOITER_UNLIM are circles, LOITER_TIME is the Lissajous curve selected by TP2D_LissShape
+    // @Range: 0 5
     // @User: Advanced
     GSCALAR(TPARAM_Flight_Plan,    "TP2D_FlightPlan",   0),  // Changed by Kaito Yamamoto 2021.08.05.
 
@@ -1917,7 +1917,7 @@ const AP_Param::Info Plane::var_info[] = {
 
     // @Param: TPARAM_dzeta
     // @DisplayName: TPARAM_dzeta
-    // @Description: TLab parameter
+    // @Description: TLab parameter, unused. The Lissajous paths look zeta up in an arc length table built at boot (TLAB_PathSegments.cpp) instead of integrating with this step. Kept so saved parameter files still load
     // @Range: 0.00001 0.001
     // @User: Advanced
     GSCALAR(TPARAM_dzeta,	"TP2D_Dzeta",	0.0001),
@@ -1936,6 +1936,36 @@ const AP_Param::Info Plane::var_info[] = {
     // @User: Advanced
     GSCALAR(TPARAM_Bar_Control_Mode, "TP2D_BarMode", 0),  // Added by Kaito Yamamoto 2021.08.15.
 
+    // @Param: TPARAM_GTab_ID
+    // @DisplayName: TPARAM_GTab_ID
+    // @Description: TLab parameter, gain table file TGAINnnn.BIN in the log directory used by the LMI altitude controller. 0 uses the built-in tables selected by TPARAM_c_alt
+    // @Range: 0 999
+    // @User: TLAB
+    GSCALAR(TPARAM_GTab_ID, "TPARAM_GTAB_ID", 0),
+
+    // @Param: TPARAM_tau_dz
+    // @DisplayName: TPARAM_tau_dz
+    // @Description: TLab parameter, time constant of the alpha-beta filter giving the altitude rate to the altitude controller. 0 gives the plain finite difference
+    // @Units: Seconds
+    // @Range: 0 1
+    // @User: Advanced
+    GSCALAR(TPARAM_tau_dz, "TPARAM_tau_dz", 0.1f),
+
+    // @Param: TPARAM_tau_dpitch
+    // @DisplayName: TPARAM_tau_dpitch
+    // @Description: TLab parameter, time constant of the alpha-beta filter giving the pitch rate to the altitude controller. 0 gives the plain finite difference
+    // @Units: Seconds
+    // @Range: 0 1
+    // @User: Advanced
+    GSCALAR(TPARAM_tau_dpitch, "TPARAM_tau_dp", 0.02f),
+
+    // @Param: TPARAM_Liss_Shape
+    // @DisplayName: TPARAM_Liss_Shape
+    // @Description: TLab parameter, path flown for every NAV_LOITER_TIME in the mission when TP2D_FlightPlan is 5. The curve is centred on the loiter location with radius TP2D_R. The loiter time (param1) is not used
+    // @Values: 0:Waypoint,1:Figure eight,2:UEC mark
+    // @User: Advanced
+    GSCALAR(TPARAM_Liss_Shape, "TP2D_LissShape", 0),
+
     AP_VAREND
 };
 
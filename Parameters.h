@@ -433,6 +433,10 @@ public:
         k_param_TPARAM_r,  // Added by Kaito Yamamoto 2021.08.05.
         k_param_TPARAM_dzeta,  // Added by Kaito Yamamoto 2021.08.05.
         k_param_TPARAM_Bar_Control_Mode,  // Added by Kaito Yamamoto 2021.08.15.
+        k_param_TPARAM_GTab_ID,
+        k_param_TPARAM_tau_dz,
+        k_param_TPARAM_tau_dpitch,
+        k_param_TPARAM_Liss_Shape,
     };
 
     AP_Int16 format_version;
@@ -696,6 +700,10 @@ public:
     AP_Float TPARAM_r;  // Added by Kaito Yamamoto 2021.08.05.
     AP_Float TPARAM_dzeta;  // Added by Kaito Yamamoto 2021.08.05.
     AP_Int8  TPARAM_Bar_Control_Mode;  // Kaito Yamamoto 2021.08.15.
+    AP_Int16 TPARAM_GTab_ID;
+    AP_Float TPARAM_tau_dz;
+    AP_Float TPARAM_tau_dpitch;
+    AP_Int8  TPARAM_Liss_Shape;
 
     // RC channels
     RC_Channel rc_1;
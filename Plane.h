@@ -103,6 +103,9 @@
 
 #include "Parameters.h"
 #include "avoidance_adsb.h"
+#include "TLAB_Geodesy.h"
+#include "TLAB_AlphaBeta.h"
+#include "TLAB_Matrix.h"
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 #include <SITL/SITL.h>
@@ -859,6 +862,10 @@ private:
     void Log_Write_PPG_2D_2();  // Added by Kaito Yamamoto 2021.07.21.
     void Log_Write_PPG_2D_3();  // Added by Kaito Yamamoto 2021.07.21.
     void Log_Write_PPG_2D_4();  // Added by Kaito Yamamoto 2021.08.05.
+    void Log_Write_PPG_Metrics();
+    void Log_Write_PPG_Boot();
+    void Log_Write_PPG_Filter();
+    void Log_Write_PPG_Mission_Hash();
     void Log_Write_Status();
     void Log_Write_Sonar();
     void Log_Write_Optflow();
@@ -1144,6 +1151,12 @@ private:
     int32_t TLAB_2D_Trace_Controller(void);  // "PPG@2oHǏ]Rg["
     // Added by Kaito Yamamoto 2021.08.11.
     int32_t TLAB_Constant_Output(void);  // ̃T[{[^[px [cdeg]o
+    void update_TLAB_params(void);  // p[^̕ύXoƑҋ@XibvVbg̍ČvZ(10Hz)
+    void init_TLAB_params(void);  // XibvVbg𑦍ɍČvZĐ؂ւ
+    void swap_TLAB_params(void);  // ҋ@XibvVbgtickEŗLɂ
+    void update_TLAB_gain_table(void);  // QCe[u̓ǂݍݗv(10Hz)
+    void swap_TLAB_gain_table(void);  // ǂݍݍς݃QCe[utickEŗLɂ
+    void TLAB_gain_table_io(void);  // QCe[ut@C̓ǂݍ(IOXbh)
 
     // ʕϐ
     bool init_TLAB_Controller_flag;
@@ -1163,8 +1176,6 @@ private:
     float L_conv;
     float Vg_min;
     float Vg_max;
-    float U_min;
-    float U_max;
     int32_t servo;
     uint16_t TLAB_CMD_index;
     bool TLAB_WP_nav_flag;
@@ -1173,11 +1184,7 @@ private:
 
     // xpϐ
     float z;
-    int32_t z_old;
-    int16_t err_count;
-    float pitch_old;
     float speed_pitch;
-    float d_pitch;
     float z_r;
     float dz;
     float e_m;
@@ -1185,7 +1192,6 @@ private:
     float motor_Th_N;
     float motor_per;
     float motor_neutral;
-    uint64_t prev_time_Th;
     uint32_t past_time_Th;
     float kp_Th[2];
     float kd_Th[2];
@@ -1202,7 +1208,11 @@ private:
     float F4;
     float gps_dh;//add by aoki 20210324
     float gps_dpitch; //added by hatae20210414
-    float dz_f;
+    // xEsb`p̎Ԕ(-tB^, TLAB_AlphaBeta.h Q)
+    TLAB_AlphaBeta tlab_ab_z;
+    TLAB_AlphaBeta tlab_ab_pitch;
+    uint64_t tlab_loc_us;  // current_loc XV [us] (update_GPS_50Hz)
+    uint64_t tlab_ahrs_us;  // AHRS XV [us] (ahrs_update)
 
     //oVbv֐(Op)
     float h_0;
@@ -1251,8 +1261,8 @@ private:
     Location Target_Circle_Center;
 
     // rp()
-    float F_fuzzy[4][2];
-    float h_mem[4];
+    TLAB_Matrix<4,2> F_fuzzy;
+    TLAB_Vector<4> h_mem;
     int8_t rule_num;
     float phi_max;
 
@@ -1271,9 +1281,11 @@ private:
     uint8_t Path_Mode;  // Ǐ]oH̎ނw(0~255)
     uint8_t Flight_Plan;  // sv(Path_Modeǂ̂悤ɐ؂ւ邩)w(0~255)
     Location Path_Origin;  // xyWň_ GPSW
+    TLAB_GeoOrigin tlab_path_origin;  // Path_Origin ƌox̃XP[
     float k_prop_const;
     //float v_a;  // ΋Cx̑傫 [m/s]: const
-    float Fx[3], Fchi[4][3];  // tB[hobNQC
+    TLAB_Vector<3> Fx;  // tB[hobNQC
+    TLAB_Matrix<4,3> Fchi;
     float v_g_min, v_g_max;
     float chiF_max;
     float kappa_max, kappa_min;
@@ -1287,10 +1299,8 @@ private:
     //float chi;  // qHp [rad] (0 ~ 2PI)
     //float v_g;  // Βnx̑傫 [m/s]
     float s;  // oH [m]
-    float s_calc;
     float zeta;  // }ϐ(oH s ƖڕWԗʂ̑Ή)
     uint16_t i_now_CMD;
-    uint16_t i_zeta;
     float dist_WPs;  // Ǐ][hɂP0,P1Ԃ̋ [m]
     float dot_zeta;  // }ϐ̎Ԕ
     float x_d;  // ڕWʒu x W(Wn)
@@ -1306,9 +1316,176 @@ private:
     float chiF;  // qHp  [m] (ZEtlWn)
     float ds;  // oH̕ω [m]
     float K1, K2, M1, M2;
-    float h_chi[4];  // o[Vbv֐(a1)
+    TLAB_Vector<4> h_chi;  // o[Vbv֐(a1)
     int32_t d_angle, bar_angle;  // t_܂̊px, Rg[o[px(t_)
 
+    // TLABRg[[vQƂp[^(g.TPARAM_*)̐̒l
+    // ύXop memcmp Ŕr邽, ݑOɕK0NA
+    struct TLAB_Param_Raw {
+        float theta_a;
+        float V_a;
+        float servo_neutral;
+        float U_min;
+        float U_max;
+        float control_a;
+        float control_b;
+        float control_p;
+        float L_1;
+        float r;
+        float tau_dz;
+        float tau_dpitch;
+        int32_t neutral_t;
+        int32_t MAX_slo;
+        int32_t cha_pow;
+        int32_t switch_mo;
+        int8_t c_alt;
+        int8_t Bar_Control_Mode;
+    };
+    // ̒l瓱o萔(zbgpX݂͂̂QƂ)
+    struct TLAB_Param_Snapshot {
+        float theta_a_rad;  // t_̃sb`p [rad]
+        float airpower;  // t_̐ [N]
+        float kk;  // ̓}bv̕␳W
+        float servo_neutral_rad;  // T[{p [rad]
+        float servo_neutral_cd;  // T[{p [cdeg]
+        float U_min_rad;  // ʂ̉ [rad]
+        float U_max_rad;  // ʂ̏ [rad]
+        float control_a;
+        float control_b;
+        float control_p;
+        float L_1;
+        float r;  // ڕWoH̑傫 [m]
+        float r_inv;  // 1/r [1/m]
+        float tau_dz;  // x̔tB^̎萔 [s]
+        float tau_dpitch;  // sb`p̔tB^̎萔 [s]
+        int32_t MAX_slo;
+        int32_t cha_pow;
+        int32_t switch_mo;
+        int8_t c_alt;
+        int8_t Bar_Control_Mode;
+    } __attribute__((aligned(64)));
+    TLAB_Param_Raw tlab_param_raw;  // ŌɍČvZƂ̐̒l
+    TLAB_Param_Snapshot tlab_param[2];  // LƑҋ@
+    uint8_t tlab_param_idx;  // L̃CfbNX
+    bool tlab_param_pending;  // ҋ@ČvZς݂Ő؂ւ҂
+    const TLAB_Param_Snapshot *tparam;  // LXibvVbg
+
+    // SDJ[h̃QCe[u(TLAB_GainTable.cpp Q)
+    // TPARAM_GTAB_ID = 0 ̂Ƃ͏]ʂR[h̃e[ugp
+    static const uint8_t TLAB_GAIN_MAX_RULES = 64;  // TLAB_Hatae_Controller  64x5 ܂Ŋi[\
+    static const uint8_t TLAB_GAIN_MAX_STATES = 5;
+    static const uint8_t TLAB_GAIN_MAX_PREMISE = 6;
+    struct TLAB_GainTable {
+        uint16_t id;
+        uint8_t n_rules;  // [(QCs̍s)
+        uint8_t n_states;  // Ԑ(QCs̗)
+        uint8_t n_premise;  // Oϐ̐
+        float z[TLAB_GAIN_MAX_PREMISE][2];  // o[Vbv֐͈̔ {max, min}
+        float F[TLAB_GAIN_MAX_RULES][TLAB_GAIN_MAX_STATES];  // tB[hobNQC
+    };
+    enum TLAB_GainTable_IO_State {
+        TLAB_GAIN_IO_IDLE = 0,
+        TLAB_GAIN_IO_READ_REQUEST,  // CXbh -> IOXbh
+        TLAB_GAIN_IO_READ_DONE,  // IOXbh -> CXbh
+        TLAB_GAIN_IO_READ_FAILED
+    };
+    TLAB_GainTable tlab_gain_pool[2];  // LƓǂݍݗp(Œ̈, s̊mۂȂ)
+    const TLAB_GainTable *tlab_gain;  // LȃQCe[u(nullptr: R[h̃e[u)
+    uint8_t tlab_gain_idx;  // L̃CfbNX
+    volatile uint8_t tlab_gain_io_state;
+    uint16_t tlab_gain_io_id;  // ǂݍݒ̃e[uID
+    uint16_t tlab_gain_failed_id;  // ǂݍ݂Ɏse[uID(ĎsȂ)
+    bool tlab_gain_io_registered;
+
+    // ~bVnavR}hRAMLbV(TLAB_MissionCache.cpp Q)
+    // sɌoHXg[Wǂ܂ɐWPQƂł悤ɂ
+    static const uint8_t TLAB_MISSION_CACHE_MAX = 64;
+    static const uint8_t TLAB_MISSION_READ_PER_TICK = 8;  // č\z1(10Hz)œǂރR}h
+    static const uint16_t TLAB_MISSION_SETTLE_MS = 2000;  // ~bV̕ύX~܂Ăč\zn߂܂ł̎ [ms]
+    struct TLAB_Mission_Item {
+        uint16_t index;  // ~bṼR}hԍ
+        uint16_t id;  // MAV_CMD
+        uint16_t p1;  // R}h̃p[^1 (, aȂ)
+        Location loc;
+    };
+    TLAB_Mission_Item tlab_mission[TLAB_MISSION_CACHE_MAX];  // navR}ĥ, R}hԍ
+    uint8_t tlab_mission_count;  // LbVnavR}h
+    uint8_t tlab_mission_cursor;  // ݂navR}h̃LbV̈ʒu
+    uint16_t tlab_mission_cursor_index;  // cursor 킹Ƃ̃R}hԍ
+    uint16_t tlab_mission_num_commands;  // LbV쐬̃R}h
+    uint32_t tlab_mission_change_ms;  // LbV쐬 mission.last_change_time_ms()
+    bool tlab_mission_valid;  // false: ύX̍č\z҂Eč\z
+    uint16_t tlab_mission_read_index;  // č\zɎɓǂރR}hԍ(0: č\złȂ)
+    uint32_t tlab_mission_build_hash;  // č\z̃nbVl
+    bool tlab_mission_truncated;  // navR}h TLAB_MISSION_CACHE_MAX 𒴂
+    uint32_t tlab_mission_hash;  // SR}h FNV-1a nbV(Abv[hȗ̔p)
+    uint32_t tlab_mission_hash_sent;  // Ō GCS ֑nbVl
+    bool tlab_mission_hash_sent_valid;  // tlab_mission_hash_sent L
+    bool tlab_mission_was_armed;  // O update_TLAB_mission_cache()  arm Ă(arm ̑Mp)
+    void send_TLAB_mission_hash(void);
+    void update_TLAB_mission_cache(void);  // LbV̍XV(10Hz, Xg[Wǂނ̂͂)
+    const TLAB_Mission_Item *TLAB_mission_lookahead(uint8_t k);  // ݂ k navR}h(nullptr: Ȃ)
+
+    // oHZOg(TLAB_PathSegments.cpp Q)
+    // T[WȐ̌oHe[u(a1, 1), Flight_Plan 5 Ń~bV琶oHZOg
+    enum {
+        TLAB_LISS_UEC = 0,  // dʑ}[N (Path_Mode 3)
+        TLAB_LISS_FIG8,  // 8̎ (Path_Mode 6)
+        TLAB_LISS_NUM
+    };
+    static const uint16_t TLAB_LISS_TABLE_N = 256;
+    float tlab_liss_s[TLAB_LISS_NUM][TLAB_LISS_TABLE_N + 1];  // zeta = i*2PI/N ܂ł̌oH(a1)
+    float tlab_liss_kappa_max[TLAB_LISS_NUM];  // ȗ̍ől(a1) [1/m]
+    uint16_t tlab_liss_hint[TLAB_LISS_NUM];  // Ǒʒu
+    void init_TLAB_path_tables(void);  // oHe[u̍쐬(N1)
+    float TLAB_lissajous_zeta(uint8_t shape, float s_m, float r);  // a r [m] ̂ƂoH s_m [m] ɑΉ zeta
+    float TLAB_lissajous_length(uint8_t shape, float zeta_end, float r);  // a r [m] ̂Ƃ zeta: 0 -> zeta_end ̌oH [m]
+
+    static const uint8_t TLAB_PATH_SEG_MAX = 32;
+    struct TLAB_Path_Segment {
+        uint8_t path_mode;  // 0: , 3/6: T[WȐ, 7: ~
+        int8_t dir;  // ~ʂ̉] (+1: , -1: E)
+        uint16_t cmd_index;  // ̃~bVR}hԍ
+        Vector2f p0;  // ̎n_ [m]
+        Vector2f p1;  // ̏I_, ~ʁET[WȐ̒S [m]
+        float r;  // ~ʁET[WȐ̔a [m]
+        float phase0;  // ~ʂ̏ʑ [rad]
+        float length;  // oH [m] (0: IȂ)
+        float kappa_max;  // ȗ̍ől [1/m]
+    };
+    TLAB_Path_Segment tlab_seg[TLAB_PATH_SEG_MAX];
+    uint8_t tlab_seg_count;
+    uint8_t tlab_seg_idx;  // Ǐ]̃ZOg
+    void TLAB_compile_path_segments(void);  // ~bVoHZOg𐶐
+    bool TLAB_add_path_segment(const TLAB_Path_Segment &seg);
+    void TLAB_set_path_segment(uint8_t idx);  // P0, P1, Path_Mode ZOg idx ɍ킹
+
+    // Ǐ]\̕]wW(init_TLAB_2D_Trace_Controller ŃZbg, PTRK OƂ1bɏo)
+    struct {
+        uint64_t start_us;  // ώZJn [us]
+        uint32_t n_2D;  // 2oHǏ]̃Tv
+        double sum_yF2;  // yF^2 ̑a [m^2] (Ԃ̔słȂ悤 double)
+        float max_abs_chiF;  // |chiF| ̍ől [rad]
+        uint32_t n_alt;  // x̃Tv
+        double sum_e_m2;  // e_m^2 ̑a [m^2]
+        double servo_sat_time;  // T[{pxOaĂ [s]
+        uint32_t gain_hash;  // tB[hobNQC̃nbVl
+    } tlab_metrics;
+    void reset_TLAB_metrics(void);
+    uint32_t TLAB_gain_hash(void);
+
+    // NԂ̓(setup() Ōv, PBOT OƂĊeO̐擪 arm \ɂȂ_ŏo)
+    struct {
+        uint32_t defaults_us;  // AP_Param::setup_sketch_defaults() [us]
+        uint32_t notify_us;  // notify.init() [us]
+        uint32_t rssi_us;  // rssi.init() [us]
+        uint32_t init_us;  // init_ardupilot() (p[^Ǎ, ZT, O, ~bV) [us]
+        uint32_t tlab_us;  // TLAB ̃p[^EoHe[ȕ [us]
+        uint32_t sched_us;  // scheduler.init() [us]
+        uint32_t setup_ms;  // setup() I(N̎) [ms]
+        uint32_t armable_ms;  // pre-arm `FbN߂Ēʉ߂ [ms] (0: ܂)
+    } tlab_boot;
+
 
 public:
     void mavlink_delay_cb();
@@ -0,0 +1,100 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+#pragma once
+
+/*
+  alpha-beta filter for the rate terms of the TLAB controllers.
+
+  The controllers used to differentiate raw samples directly, e.g. the
+  altitude rate from centimetre-quantised current_loc.alt. At 400Hz a
+  single 1cm step then shows up as 4m/s of climb rate. This filter
+  tracks a value and its rate with a constant-velocity model. It only
+  steps when it is given a newer timestamp, so a repeated call or a
+  zero dt changes nothing. Callers pass the time the sample was taken,
+  not the time of the call: current_loc only changes at 50Hz, and
+  feeding the same altitude at 400Hz would pull the rate towards zero.
+
+  The gains are the critically damped pair for time constant tau,
+  recomputed from each sample's dt so uneven sample spacing is handled:
+
+    theta = exp(-dt/tau),  alpha = 1 - theta^2,  beta = (1 - theta)^2
+
+  With tau = 0, alpha = beta = 1 and the rate is exactly the finite
+  difference (x[k] - x[k-1])/dt, i.e. the old behaviour.
+
+  The innovation (measurement minus prediction) is accumulated for
+  logging. Its RMS shows how much noise the filter is removing, and a
+  growing mean square means tau is too long for the dynamics.
+ */
+
+#include <AP_Math/AP_Math.h>
+
+class TLAB_AlphaBeta {
+public:
+    TLAB_AlphaBeta() :
+        _x(0), _v(0), _last_us(0), _dt_us(0), _initialised(false),
+        _n(0), _sum_r2(0), _max_abs_r(0) {}
+
+    // the next update() starts again from its measurement, with zero rate
+    void reset(void) { _initialised = false; }
+
+    /*
+      measurement meas taken at t_us. Returns false without changing
+      anything when t_us is not newer than the previous sample
+     */
+    bool update(float meas, uint64_t t_us, float tau) {
+        if (!_initialised) {
+            _x = meas;
+            _v = 0;
+            _last_us = t_us;
+            _dt_us = 0;
+            _initialised = true;
+            return true;
+        }
+        if (t_us <= _last_us) {
+            return false;
+        }
+        _dt_us = t_us - _last_us;
+        _last_us = t_us;
+        float dt = _dt_us * 1.0e-6f;
+
+        float theta = (tau > 0) ? expf(-dt / tau) : 0.0f;
+        float alpha = 1 - theta*theta;
+        float beta = (1 - theta)*(1 - theta);
+
+        float x_pred = _x + _v*dt;
+        float r = meas - x_pred;
+        _x = x_pred + alpha*r;
+        _v += beta/dt*r;
+
+        _n++;
+        _sum_r2 += r*r;
+        _max_abs_r = MAX(_max_abs_r, fabsf(r));
+        return true;
+    }
+
+    float get(void) const { return _x; }
+    float get_rate(void) const { return _v; }
+    // time between the last two samples [us]
+    uint32_t get_dt_us(void) const { return _dt_us; }
+
+    // innovation statistics since the last reset_stats()
+    uint32_t get_count(void) const { return _n; }
+    float get_innovation_rms(void) const { return _n > 0 ? sqrtf(_sum_r2/_n) : 0.0f; }
+    float get_innovation_max(void) const { return _max_abs_r; }
+    void reset_stats(void) {
+        _n = 0;
+        _sum_r2 = 0;
+        _max_abs_r = 0;
+    }
+
+private:
+    float _x;  // filtered value
+    float _v;  // filtered rate [1/s]
+    uint64_t _last_us;
+    uint32_t _dt_us;
+    bool _initialised;
+
+    uint32_t _n;
+    float _sum_r2;
+    float _max_abs_r;
+};
@@ -0,0 +1,130 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+#pragma once
+
+/*
+  polynomial sin/cos/atan2/asin for the TLAB controllers.
+
+  The coefficients are minimax fits. Maximum absolute errors against
+  the double precision functions, measured on a host over single
+  precision inputs:
+
+    tlab_sinf (and sin of tlab_sincosf)  1.7e-7   (|x| <= 100 rad)
+    tlab_cosf (and cos of tlab_sincosf)  2.1e-7   (|x| <= 100 rad)
+    tlab_atan2f                          3.1e-7 rad
+    tlab_asinf                           3.0e-7 rad
+
+  For scale, one centidegree of servo command is 1.7e-4 rad, so these
+  can replace the libm calls in the controllers.
+
+  Angles are reduced with a two-part PI, which keeps the reduction
+  exact to about |x| = 1000 rad. The controllers only pass wrapped
+  angles or small multiples of zeta.
+ */
+
+#include <AP_Math/AP_Math.h>
+
+#define TLAB_PI_HI   3.140625f
+#define TLAB_PI_LO   9.67653589793e-4f
+#define TLAB_INV_PI  0.318309886f
+#define TLAB_HALF_PI 1.57079633f
+#define TLAB_PI_F    3.14159265f
+
+/*
+  x = r + k*PI with r in [-PI/2, PI/2]. Returns true when k is odd,
+  i.e. when the sign of sin and cos flips
+ */
+static inline bool tlab_reduce_pi(float x, float &r)
+{
+    float k = roundf(x * TLAB_INV_PI);
+    r = (x - k*TLAB_PI_HI) - k*TLAB_PI_LO;
+    return (((int32_t)k) & 1) != 0;
+}
+
+// sin(r) and cos(r) on [-PI/2, PI/2]
+static inline float tlab_sin_poly(float r)
+{
+    float r2 = r*r;
+    return r*(0.999999977f + r2*(-0.166666476f + r2*(0.00833289982f +
+              r2*(-0.000198008976f + r2*2.59048825e-06f))));
+}
+
+static inline float tlab_cos_poly(float r)
+{
+    float r2 = r*r;
+    return 0.999999953f + r2*(-0.499999053f + r2*(0.0416635847f +
+           r2*(-0.00138537042f + r2*2.31539289e-05f)));
+}
+
+static inline float tlab_sinf(float x)
+{
+    float r;
+    bool odd = tlab_reduce_pi(x, r);
+    float s = tlab_sin_poly(r);
+    return odd ? -s : s;
+}
+
+static inline float tlab_cosf(float x)
+{
+    float r;
+    bool odd = tlab_reduce_pi(x, r);
+    float c = tlab_cos_poly(r);
+    return odd ? -c : c;
+}
+
+// sin and cos of the same angle with one reduction
+static inline void tlab_sincosf(float x, float &s, float &c)
+{
+    float r;
+    bool odd = tlab_reduce_pi(x, r);
+    s = tlab_sin_poly(r);
+    c = tlab_cos_poly(r);
+    if (odd) {
+        s = -s;
+        c = -c;
+    }
+}
+
+// atan(z) on [0, 1]
+static inline float tlab_atan_poly(float z)
+{
+    float z2 = z*z;
+    return z*(0.999999336f + z2*(-0.333298608f + z2*(0.199465654f + z2*(-0.139086281f +
+              z2*(0.0964219352f + z2*(-0.055912273f + z2*(0.0218629194f + z2*-0.00405455624f)))))));
+}
+
+// fold atan(min/max) of the first octant back to the full circle
+static inline float tlab_atan2_octant(float y, float x, float a, bool swapped)
+{
+    if (swapped) {
+        a = TLAB_HALF_PI - a;
+    }
+    if (x < 0) {
+        a = TLAB_PI_F - a;
+    }
+    return (y < 0) ? -a : a;
+}
+
+static inline float tlab_atan2f(float y, float x)
+{
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    float mx = MAX(ax, ay);
+    if (mx <= 0) {
+        return 0;
+    }
+    bool swapped = ay > ax;
+    float z = (swapped ? ax : ay) / mx;
+    return tlab_atan2_octant(y, x, tlab_atan_poly(z), swapped);
+}
+
+/*
+  asin(x), x is clamped to [-1, 1]. Abramowitz and Stegun 4.4.46
+ */
+static inline float tlab_asinf(float x)
+{
+    float ax = MIN(fabsf(x), 1.0f);
+    float p = 1.5707963050f + ax*(-0.2145988016f + ax*(0.0889789874f + ax*(-0.0501743046f +
+              ax*(0.0308918810f + ax*(-0.0170881256f + ax*(0.0066700901f + ax*-0.0012624911f))))));
+    float a = TLAB_HALF_PI - sqrtf(1 - ax)*p;
+    return (x < 0) ? -a : a;
+}
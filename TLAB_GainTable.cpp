@@ -0,0 +1,193 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/*
+  gain tables for the TLAB TS-fuzzy controllers, loaded from the log
+  storage instead of being compiled in.
+
+  A table lives in <log directory>/TGAINnnn.BIN, where nnn is
+  TPARAM_GTAB_ID. The file is little-endian and packed:
+
+    uint32_t magic        TLAB_GAIN_MAGIC
+    uint16_t version      TLAB_GAIN_VERSION
+    uint16_t id           must equal nnn
+    uint8_t  n_rules      rows of F
+    uint8_t  n_states     columns of F
+    uint8_t  n_premise    number of premise variables
+    uint8_t  reserved
+    float    z[n_premise][2]       membership bounds {max, min}
+    float    F[n_rules][n_states]  feedback gains
+    uint16_t crc          crc16_ccitt over everything above
+
+  The file is read on the IO thread into the spare slot of a fixed
+  two-entry pool, then swapped in by the main loop at the start of a
+  tick, so the controllers never see a half-loaded table and never
+  parse anything in the fast loop. If a table cannot be loaded the
+  controllers go back to the compiled-in tables, so the active gains
+  always match TPARAM_GTAB_ID or the built-in set.
+ */
+
+#include "Plane.h"
+
+#if HAL_OS_POSIX_IO
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+#define TLAB_GAIN_MAGIC   0x42544754UL  // "TGTB"
+#define TLAB_GAIN_VERSION 1
+
+struct PACKED tlab_gain_file_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t id;
+    uint8_t n_rules;
+    uint8_t n_states;
+    uint8_t n_premise;
+    uint8_t reserved;
+};
+
+/*
+  request a new table when TPARAM_GTAB_ID changes. Called at 10Hz
+  from update_TLAB_params()
+ */
+void Plane::update_TLAB_gain_table(void)
+{
+    uint16_t id = (uint16_t)constrain_int16(g.TPARAM_GTab_ID, 0, 999);
+    uint16_t active_id = (tlab_gain != nullptr) ? tlab_gain->id : 0;
+
+    if (tlab_gain_io_state != TLAB_GAIN_IO_IDLE) {
+        // a read is in flight or waiting to be swapped in
+        return;
+    }
+    if (id == 0) {
+        // back to the compiled-in tables
+        tlab_gain = nullptr;
+        tlab_gain_failed_id = 0;
+        return;
+    }
+    if (id == active_id || id == tlab_gain_failed_id) {
+        return;
+    }
+
+#if HAL_OS_POSIX_IO
+    if (!tlab_gain_io_registered) {
+        tlab_gain_io_registered = true;
+        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&Plane::TLAB_gain_table_io, void));
+    }
+    tlab_gain_io_id = id;
+    tlab_gain_io_state = TLAB_GAIN_IO_READ_REQUEST;
+#else
+    gcs_send_text_fmt(MAV_SEVERITY_WARNING, "Gain table %u: no filesystem, using built-in tables", (unsigned)id);
+    tlab_gain = nullptr;
+    tlab_gain_failed_id = id;
+#endif
+}
+
+/*
+  make a freshly loaded table active. Called at the start of
+  stabilize() so a table never changes in the middle of a tick
+ */
+void Plane::swap_TLAB_gain_table(void)
+{
+    switch (tlab_gain_io_state) {
+    case TLAB_GAIN_IO_READ_DONE:
+        tlab_gain_idx ^= 1;
+        tlab_gain = &tlab_gain_pool[tlab_gain_idx];
+        tlab_gain_failed_id = 0;
+        tlab_gain_io_state = TLAB_GAIN_IO_IDLE;
+        gcs_send_text_fmt(MAV_SEVERITY_INFO, "Gain table %u loaded (%ux%u)",
+                          (unsigned)tlab_gain->id,
+                          (unsigned)tlab_gain->n_rules,
+                          (unsigned)tlab_gain->n_states);
+        break;
+
+    case TLAB_GAIN_IO_READ_FAILED:
+        // fall back to the compiled-in tables rather than keep flying
+        // a table that TPARAM_GTAB_ID no longer names, and don't retry
+        // until the ID is changed
+        tlab_gain = nullptr;
+        tlab_gain_failed_id = tlab_gain_io_id;
+        tlab_gain_io_state = TLAB_GAIN_IO_IDLE;
+        gcs_send_text_fmt(MAV_SEVERITY_WARNING, "Gain table %u: load failed, using built-in tables",
+                          (unsigned)tlab_gain_io_id);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+  read and validate the requested table into the spare pool slot. Runs
+  on the IO thread
+ */
+void Plane::TLAB_gain_table_io(void)
+{
+    if (tlab_gain_io_state != TLAB_GAIN_IO_READ_REQUEST) {
+        return;
+    }
+
+#if HAL_OS_POSIX_IO
+    TLAB_GainTable &t = tlab_gain_pool[tlab_gain_idx ^ 1];
+    struct tlab_gain_file_header hdr;
+    uint16_t crc_file;
+    uint16_t crc;
+    uint16_t len_z, len_row;
+    bool ok = false;
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s/TGAIN%03u.BIN", HAL_BOARD_LOG_DIRECTORY, (unsigned)tlab_gain_io_id);
+    int fd = ::open(path, O_RDONLY);
+    if (fd == -1) {
+        goto done;
+    }
+    if (::read(fd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr)) {
+        goto done;
+    }
+    if (hdr.magic != TLAB_GAIN_MAGIC ||
+        hdr.version != TLAB_GAIN_VERSION ||
+        hdr.id != tlab_gain_io_id ||
+        hdr.n_rules == 0 || hdr.n_rules > TLAB_GAIN_MAX_RULES ||
+        hdr.n_states == 0 || hdr.n_states > TLAB_GAIN_MAX_STATES ||
+        hdr.n_premise > TLAB_GAIN_MAX_PREMISE) {
+        goto done;
+    }
+    crc = crc16_ccitt((const uint8_t *)&hdr, sizeof(hdr), 0);
+
+    // read straight into the spare slot; it is not visible to the
+    // controllers until swap_TLAB_gain_table()
+    memset(&t, 0, sizeof(t));
+    len_z = sizeof(float) * 2 * hdr.n_premise;
+    if (::read(fd, t.z, len_z) != (ssize_t)len_z) {
+        goto done;
+    }
+    crc = crc16_ccitt((const uint8_t *)t.z, len_z, crc);
+    len_row = sizeof(float) * hdr.n_states;
+    for (uint8_t i = 0; i < hdr.n_rules; i++) {
+        if (::read(fd, t.F[i], len_row) != (ssize_t)len_row) {
+            goto done;
+        }
+        crc = crc16_ccitt((const uint8_t *)t.F[i], len_row, crc);
+    }
+    if (::read(fd, &crc_file, sizeof(crc_file)) != (ssize_t)sizeof(crc_file) ||
+        crc != crc_file) {
+        goto done;
+    }
+    t.id = hdr.id;
+    t.n_rules = hdr.n_rules;
+    t.n_states = hdr.n_states;
+    t.n_premise = hdr.n_premise;
+    ok = true;
+
+done:
+    if (fd != -1) {
+        ::close(fd);
+    }
+    tlab_gain_io_state = ok ? TLAB_GAIN_IO_READ_DONE : TLAB_GAIN_IO_READ_FAILED;
+#else
+    tlab_gain_io_state = TLAB_GAIN_IO_READ_FAILED;
+#endif
+}
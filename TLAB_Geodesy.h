@@ -0,0 +1,104 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+#pragma once
+
+/*
+  flat-earth offsets, distances and bearings from one origin to many
+  points.
+
+  get_distance(), get_bearing_cd() and location_diff() each take one
+  pair of Locations, recompute cos(lat) on every call, and the bearing
+  comes back in int32 centidegrees. The TLAB code keeps converting
+  those straight back to radians. Here the origin's longitude scale is
+  computed once in tlab_geo_set_origin(), and the batch functions take
+  latitude/longitude arrays (structure of arrays) so the loops have no
+  dependencies between iterations. Bearings are in radians.
+
+  All points use the origin's longitude scale, as location_diff()
+  does. get_distance() and get_bearing_cd() use the scale at the second
+  point instead; over a few km the difference is below 1e-3 of the
+  distance.
+ */
+
+#include <AP_Math/AP_Math.h>
+
+struct TLAB_GeoOrigin {
+    int32_t lat;  // [1e-7 deg]
+    int32_t lng;  // [1e-7 deg]
+    float lng_scale;  // cos(lat), as longitude_scale()
+};
+
+static inline void tlab_geo_set_origin(TLAB_GeoOrigin &o, const Location &loc)
+{
+    o.lat = loc.lat;
+    o.lng = loc.lng;
+    o.lng_scale = constrain_float(cosf(loc.lat * 1.0e-7f * DEG_TO_RAD), 0.01f, 1.0f);
+}
+
+// north/east offset [m] of one point, same as location_diff(origin, loc)
+static inline void tlab_geo_ne(const TLAB_GeoOrigin &o, int32_t lat, int32_t lng, float &north, float &east)
+{
+    north = (lat - o.lat) * LOCATION_SCALING_FACTOR;
+    east = (lng - o.lng) * LOCATION_SCALING_FACTOR * o.lng_scale;
+}
+
+/*
+  position in the TLAB path frame [m]: x east, y north. This is the
+  location_diff() result with its components swapped
+ */
+static inline Vector2f tlab_geo_xy(const TLAB_GeoOrigin &o, const Location &loc)
+{
+    float north, east;
+    tlab_geo_ne(o, loc.lat, loc.lng, north, east);
+    return Vector2f(east, north);
+}
+
+// distance [m] from the origin
+static inline float tlab_geo_distance(const TLAB_GeoOrigin &o, const Location &loc)
+{
+    float north, east;
+    tlab_geo_ne(o, loc.lat, loc.lng, north, east);
+    return norm(north, east);
+}
+
+// bearing from the origin [rad], 0 = north, clockwise, 0 ~ 2PI
+static inline float tlab_geo_bearing(const TLAB_GeoOrigin &o, const Location &loc)
+{
+    float north, east;
+    tlab_geo_ne(o, loc.lat, loc.lng, north, east);
+    return wrap_2PI(atan2f(east, north));
+}
+
+/*
+  batch forms over n points
+ */
+static inline void tlab_geo_ne_n(const TLAB_GeoOrigin &o, const int32_t *lat, const int32_t *lng,
+                                 float *north, float *east, uint16_t n)
+{
+    const float ks = LOCATION_SCALING_FACTOR * o.lng_scale;
+    for (uint16_t i = 0; i < n; i++) {
+        north[i] = (lat[i] - o.lat) * LOCATION_SCALING_FACTOR;
+        east[i] = (lng[i] - o.lng) * ks;
+    }
+}
+
+static inline void tlab_geo_distance_n(const TLAB_GeoOrigin &o, const int32_t *lat, const int32_t *lng,
+                                       float *dist, uint16_t n)
+{
+    const float ks = LOCATION_SCALING_FACTOR * o.lng_scale;
+    for (uint16_t i = 0; i < n; i++) {
+        float north = (lat[i] - o.lat) * LOCATION_SCALING_FACTOR;
+        float east = (lng[i] - o.lng) * ks;
+        dist[i] = sqrtf(north*north + east*east);
+    }
+}
+
+static inline void tlab_geo_bearing_n(const TLAB_GeoOrigin &o, const int32_t *lat, const int32_t *lng,
+                                      float *bearing, uint16_t n)
+{
+    const float ks = LOCATION_SCALING_FACTOR * o.lng_scale;
+    for (uint16_t i = 0; i < n; i++) {
+        float north = (lat[i] - o.lat) * LOCATION_SCALING_FACTOR;
+        float east = (lng[i] - o.lng) * ks;
+        bearing[i] = wrap_2PI(atan2f(east, north));
+    }
+}
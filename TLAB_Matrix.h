@@ -0,0 +1,96 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+#pragma once
+
+/*
+  fixed-size vectors and matrices for the TLAB controllers.
+
+  The TS-fuzzy controllers compute u = -sum_i h_i F_i x, with gain
+  matrices of 8x4 (altitude), 4x3 (2D path) and 4x2 (fuzzy attitude).
+  They used to be written out as nested loops over C arrays in each
+  controller. The sizes are fixed when the code is compiled, so here
+  they are template parameters. Nothing is allocated, and the inner
+  product is unrolled by template recursion, so it stays unrolled in
+  the -Os firmware builds, where the compiler would not unroll the
+  loops itself. The generic routines in matrix_alg.cpp take sizes at
+  run time and allocate with new, so they are not usable in the fast
+  loop.
+
+  Both types are aggregates holding one plain array. They can be brace
+  initialised, memcpy'd and hashed like the arrays they replace, and
+  operator[] gives the same element syntax: v[i] and m[i][j].
+ */
+
+#include <AP_Math/AP_Math.h>
+
+// a[0]*b[0] + ... + a[N-1]*b[N-1], unrolled at compile time
+template <uint8_t N>
+struct TLAB_Dot {
+    static inline float run(const float *a, const float *b) {
+        return TLAB_Dot<N-1>::run(a, b) + a[N-1]*b[N-1];
+    }
+};
+
+template <>
+struct TLAB_Dot<1> {
+    static inline float run(const float *a, const float *b) {
+        return a[0]*b[0];
+    }
+};
+
+template <uint8_t N>
+struct TLAB_Vector {
+    static const uint8_t size = N;
+    float v[N];
+
+    float &operator[](uint8_t i) { return v[i]; }
+    const float &operator[](uint8_t i) const { return v[i]; }
+
+    float dot(const TLAB_Vector<N> &b) const { return TLAB_Dot<N>::run(v, b.v); }
+};
+
+template <uint8_t R, uint8_t C>
+struct TLAB_Matrix {
+    static const uint8_t rows = R;
+    static const uint8_t cols = C;
+    float m[R][C];
+
+    // row i, so that m[i][j] works as for a float[R][C]
+    float *operator[](uint8_t i) { return m[i]; }
+    const float *operator[](uint8_t i) const { return m[i]; }
+
+    /*
+      copy from the top-left corner of a larger row-major array, such
+      as a gain table whose rows are stride floats apart
+     */
+    void load(const float *src, uint8_t stride) {
+        for (uint8_t i = 0; i < R; i++) {
+            memcpy(m[i], &src[i*stride], sizeof(m[i]));
+        }
+    }
+
+    TLAB_Vector<R> operator*(const TLAB_Vector<C> &x) const {
+        TLAB_Vector<R> y;
+        for (uint8_t i = 0; i < R; i++) {
+            y.v[i] = TLAB_Dot<C>::run(m[i], x.v);
+        }
+        return y;
+    }
+};
+
+/*
+  u0 - sum_i h_i (F_i x): the output of a TS-fuzzy controller with R
+  rules and C states around the operating point u0. The sum is taken in
+  the order of the loops it replaced, u -= h_i*(F_i x) for i = 0..R-1
+  with each row product summed j = 0..C-1, so the result is the same to
+  the bit
+ */
+template <uint8_t R, uint8_t C>
+static inline float tlab_fuzzy_feedback(float u0, const TLAB_Vector<R> &h, const TLAB_Matrix<R,C> &F,
+                                        const TLAB_Vector<C> &x)
+{
+    float u = u0;
+    for (uint8_t i = 0; i < R; i++) {
+        u -= h.v[i]*TLAB_Dot<C>::run(F.m[i], x.v);
+    }
+    return u;
+}
@@ -0,0 +1,217 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/*
+  RAM cache of the mission's navigation commands for the TLAB path
+  controllers.
+
+  AP_Mission reads every command from storage on demand, and
+  get_next_nav_cmd() rescans from the given index each time. The path
+  generator wants to look several waypoints ahead while flying, so the
+  nav commands are decoded once into tlab_mission[] and rebuilt only
+  when the mission changes (upload, single item write, clear or
+  truncate all bump mission.last_change_time_ms()).
+
+  Storage is only read from the 10Hz task, never from the fast loop.
+  An upload bumps last_change_time_ms() once per item, so the rebuild
+  waits until the mission has not changed for TLAB_MISSION_SETTLE_MS,
+  then reads TLAB_MISSION_READ_PER_TICK commands per call. The cache is
+  marked invalid from the first change until the rebuild completes.
+
+  The cache follows plain command order. DO_JUMP is not followed, so a
+  lookahead across a jump returns the commands as stored.
+
+  While rebuilding, every stored command after home (nav or not) is
+  also hashed with 32-bit FNV-1a over the MISSION_ITEM_INT fields the
+  vehicle would send back for it on a mission download, packed
+  little-endian in this order:
+
+    command (uint16), frame (uint8), param1..param4 (float),
+    x (int32, lat*1e7), y (int32, lng*1e7), z (float, alt [m])
+
+  i.e. Python struct format "<HBffffiif", 31 bytes per item, starting
+  from the FNV offset basis 0x811c9dc5. Fields a command does not use
+  are 0, including frame for commands without a location. A command
+  the vehicle cannot send back is hashed as zeros apart from its
+  command number. A ground script can compute the same hash from a
+  downloaded mission, or from the items it is about to upload as long
+  as they survive the round trip (e.g. integer-valued params that are
+  stored as integers), and skip identical uploads.
+
+  The hash is logged as PMSH after every rebuild and at the start of
+  each log. It is sent to the GCS as a STATUSTEXT when a rebuild gives
+  a different hash from the one last sent, and again when the vehicle
+  is armed, so the record of each flight shows which mission it flew.
+  It is not repeated otherwise, to keep the GCS message pane quiet.
+ */
+
+#include "Plane.h"
+
+static uint32_t tlab_fnv1a(uint32_t hash, const void *data, uint16_t len)
+{
+    const uint8_t *b = (const uint8_t *)data;
+    for (uint16_t i = 0; i < len; i++) {
+        hash ^= b[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/*
+  add one command to the mission hash in its MISSION_ITEM_INT form, see
+  above. The firmware targets are little-endian, so the fields are
+  copied as they are
+ */
+static uint32_t tlab_hash_mission_item(uint32_t hash, const AP_Mission::Mission_Command &cmd)
+{
+    mavlink_mission_item_int_t packet;
+    memset(&packet, 0, sizeof(packet));
+    if (!AP_Mission::mission_cmd_to_mavlink_int(cmd, packet)) {
+        memset(&packet, 0, sizeof(packet));
+        packet.command = cmd.id;
+    }
+    hash = tlab_fnv1a(hash, &packet.command, sizeof(packet.command));
+    hash = tlab_fnv1a(hash, &packet.frame, sizeof(packet.frame));
+    hash = tlab_fnv1a(hash, &packet.param1, sizeof(packet.param1));
+    hash = tlab_fnv1a(hash, &packet.param2, sizeof(packet.param2));
+    hash = tlab_fnv1a(hash, &packet.param3, sizeof(packet.param3));
+    hash = tlab_fnv1a(hash, &packet.param4, sizeof(packet.param4));
+    hash = tlab_fnv1a(hash, &packet.x, sizeof(packet.x));
+    hash = tlab_fnv1a(hash, &packet.y, sizeof(packet.y));
+    hash = tlab_fnv1a(hash, &packet.z, sizeof(packet.z));
+    return hash;
+}
+
+/*
+  send the mission hash to the GCS
+ */
+void Plane::send_TLAB_mission_hash(void)
+{
+    tlab_mission_hash_sent = tlab_mission_hash;
+    tlab_mission_hash_sent_valid = true;
+    gcs_send_text_fmt(MAV_SEVERITY_INFO, "Mission %u cmds hash %08lx",
+                      (unsigned)tlab_mission_num_commands, (unsigned long)tlab_mission_hash);
+}
+
+/*
+  rebuild the cache when the stored mission has changed, a few commands
+  per call. Called at 10Hz from update_TLAB_params()
+ */
+void Plane::update_TLAB_mission_cache(void)
+{
+    const uint16_t num_commands = mission.num_commands();
+    const uint32_t change_ms = mission.last_change_time_ms();
+    if (change_ms != tlab_mission_change_ms ||
+        num_commands != tlab_mission_num_commands) {
+        // drop the cache, or a rebuild in progress, as soon as the
+        // mission changes
+        tlab_mission_valid = false;
+        tlab_mission_read_index = 0;
+        tlab_mission_change_ms = change_ms;
+        tlab_mission_num_commands = num_commands;
+    }
+    const bool armed = arming.is_armed();
+    if (armed && !tlab_mission_was_armed && tlab_mission_valid) {
+        // once per arming; a rebuild that finishes while armed sends
+        // its own when the hash differs
+        send_TLAB_mission_hash();
+    }
+    tlab_mission_was_armed = armed;
+    if (tlab_mission_valid) {
+        return;
+    }
+
+    if (tlab_mission_read_index == 0) {
+        if (AP_HAL::millis() - change_ms < TLAB_MISSION_SETTLE_MS) {
+            // still being uploaded
+            return;
+        }
+        tlab_mission_count = 0;
+        tlab_mission_truncated = false;
+        tlab_mission_build_hash = 2166136261UL;
+        // command 0 is home
+        tlab_mission_read_index = 1;
+    }
+
+    AP_Mission::Mission_Command cmd;
+    for (uint8_t n = 0; n < TLAB_MISSION_READ_PER_TICK; n++) {
+        uint16_t i = tlab_mission_read_index;
+        if (i >= num_commands) {
+            break;
+        }
+        // commands with a 16 bit id only fill 10 of the content bytes
+        memset(cmd.content.bytes, 0, sizeof(cmd.content.bytes));
+        if (!mission.read_cmd_from_storage(i, cmd)) {
+            // treat as the end of the mission
+            tlab_mission_read_index = num_commands;
+            break;
+        }
+        tlab_mission_read_index++;
+
+        tlab_mission_build_hash = tlab_hash_mission_item(tlab_mission_build_hash, cmd);
+        if (!AP_Mission::is_nav_cmd(cmd)) {
+            continue;
+        }
+        if (tlab_mission_count >= TLAB_MISSION_CACHE_MAX) {
+            // keep reading for the hash
+            tlab_mission_truncated = true;
+            continue;
+        }
+        TLAB_Mission_Item &item = tlab_mission[tlab_mission_count++];
+        item.index = i;
+        item.id = cmd.id;
+        item.p1 = cmd.p1;
+        item.loc = cmd.content.location;
+    }
+    if (tlab_mission_read_index < num_commands) {
+        // more next time
+        return;
+    }
+
+    tlab_mission_read_index = 0;
+    tlab_mission_cursor = 0;
+    tlab_mission_cursor_index = 0;
+    tlab_mission_valid = true;
+
+    if (tlab_mission_truncated) {
+        gcs_send_text_fmt(MAV_SEVERITY_WARNING, "TLAB mission cache full (%u nav cmds)",
+                          (unsigned)TLAB_MISSION_CACHE_MAX);
+    }
+    tlab_mission_hash = tlab_mission_build_hash;
+    Log_Write_PPG_Mission_Hash();
+    if (!tlab_mission_hash_sent_valid || tlab_mission_hash != tlab_mission_hash_sent) {
+        send_TLAB_mission_hash();
+    }
+}
+
+/*
+  return the k'th navigation command from the current one (k = 0 is the
+  current command), or nullptr if the mission ends before that. The
+  cursor only moves forward as the mission advances, so this is O(1)
+  except for one short walk after each waypoint change.
+ */
+const Plane::TLAB_Mission_Item *Plane::TLAB_mission_lookahead(uint8_t k)
+{
+    if (!tlab_mission_valid || tlab_mission_count == 0) {
+        return nullptr;
+    }
+
+    uint16_t current = mission.get_current_nav_index();
+    if (current != tlab_mission_cursor_index) {
+        if (tlab_mission_cursor >= tlab_mission_count ||
+            tlab_mission[tlab_mission_cursor].index > current) {
+            // jumped backwards (DO_JUMP, restart or set_current_cmd)
+            tlab_mission_cursor = 0;
+        }
+        while (tlab_mission_cursor < tlab_mission_count &&
+               tlab_mission[tlab_mission_cursor].index < current) {
+            tlab_mission_cursor++;
+        }
+        tlab_mission_cursor_index = current;
+    }
+
+    uint16_t pos = tlab_mission_cursor + k;
+    if (pos >= tlab_mission_count) {
+        return nullptr;
+    }
+    return &tlab_mission[pos];
+}
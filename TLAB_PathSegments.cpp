@@ -0,0 +1,361 @@
+// -*- tab-width: 4; Mode: C++; c-basic-offset: 4; indent-tabs-mode: nil -*-
+
+/*
+  parametric path segments for the TLAB 2D path controller.
+
+  Lissajous paths (Path_Mode 3 and 6) need zeta as a function of the
+  arc length s. This used to be found by integrating |dP/dzeta| from
+  the last zeta every tick, with no bound on the number of steps. The
+  arc length scales with the radius, so the integral is now tabulated
+  once at boot for r = 1 over one period, and each tick does a short
+  hinted walk through the table plus a linear interpolation.
+
+  Flight_Plan 5 builds the path from the mission instead of from
+  compiled-in rules. When the 2D controller starts, the cached nav
+  commands (TLAB_MissionCache.cpp) from the current one onwards are
+  turned into a list of segments in the path frame:
+
+    NAV_WAYPOINT      line to the waypoint
+    NAV_LOITER_TURNS  circle around the waypoint, radius from the high
+                      byte of p1 (0: TP2D_R), turns from the low byte,
+                      direction from the CCW flag
+    NAV_LOITER_UNLIM  endless circle around the waypoint, radius p1
+    NAV_LOITER_TIME   Lissajous curve centred on the waypoint, radius
+                      TP2D_R, shape from TP2D_LissShape (0: fly it as
+                      a waypoint, 1: figure eight, 2: UEC mark). p1 is
+                      the loiter time and is left alone
+
+  Any other nav command with a position is flown as a waypoint. A
+  connecting line is inserted wherever a segment does not start where
+  the previous one ended, so the reference point never jumps. The
+  controller moves on to the next segment when s passes the segment
+  length; the remainder of s carries over.
+
+  The reference heading chi_d is only continuous where a line joins a
+  circle from outside it: the line ends at the tangent point on the
+  side that matches the direction of turn. Starting inside a circle,
+  leaving a circle, and entering or leaving a Lissajous curve keep the
+  position continuous but can step chi_d.
+ */
+
+#include "Plane.h"
+
+// zeta step of the Lissajous tables (one period is 2PI for both shapes)
+#define TLAB_LISS_DZETA (2*M_PI/Plane::TLAB_LISS_TABLE_N)
+// Simpson sub-intervals per table step
+#define TLAB_LISS_SIMPSON_N 4
+
+/*
+  |dP/dzeta| of the unit-radius Lissajous curves (uec: UEC mark,
+  otherwise figure eight)
+ */
+static float tlab_liss_speed(bool uec, float zeta)
+{
+    if (uec) {
+        // x = -cos(5 zeta), y = cos(6 zeta)
+        float s5 = sinf(5*zeta);
+        float s6 = sinf(6*zeta);
+        return sqrtf(25*s5*s5 + 36*s6*s6);
+    }
+    // x = 2 sin(zeta), y = sin(2 zeta)
+    float c1 = cosf(zeta);
+    float c2 = cosf(2*zeta);
+    return 2*sqrtf(c1*c1 + c2*c2);
+}
+
+/*
+  curvature of the unit-radius Lissajous curves, same expressions as the
+  kappa of Path_Mode 3 and 6
+ */
+static float tlab_liss_kappa(bool uec, float zeta)
+{
+    if (uec) {
+        float den = powf(25*powf(sinf(5*zeta), 2) + 36*powf(sinf(6*zeta), 2), 1.5f);
+        if (den < 1.0e-6f) {
+            return 0;
+        }
+        return 15*fabsf(11*sinf(zeta) - sinf(11*zeta)) / den;
+    }
+    float sz = sinf(zeta);
+    float cz = cosf(zeta);
+    return - (fabsf(sz)*(2*sz*sz - 3)) / (2*powf(4*powf(cz, 4) - 3*cz*cz + 1, 1.5f));
+}
+
+/*
+  tabulate the arc length of the unit-radius Lissajous curves. Called
+  once from setup()
+ */
+void Plane::init_TLAB_path_tables(void)
+{
+    const float h = TLAB_LISS_DZETA / TLAB_LISS_SIMPSON_N;
+    for (uint8_t shape = 0; shape < TLAB_LISS_NUM; shape++) {
+        const bool uec = (shape == TLAB_LISS_UEC);
+        float *tab = tlab_liss_s[shape];
+        float kmax = 0;
+        tab[0] = 0;
+        for (uint16_t i = 0; i < TLAB_LISS_TABLE_N; i++) {
+            float z0 = i * TLAB_LISS_DZETA;
+            float sum = 0;
+            for (uint8_t j = 0; j < TLAB_LISS_SIMPSON_N; j++) {
+                float a = z0 + j*h;
+                sum += (tlab_liss_speed(uec, a) +
+                        4*tlab_liss_speed(uec, a + 0.5f*h) +
+                        tlab_liss_speed(uec, a + h)) * h / 6;
+            }
+            tab[i+1] = tab[i] + sum;
+            kmax = MAX(kmax, fabsf(tlab_liss_kappa(uec, z0)));
+        }
+        tlab_liss_kappa_max[shape] = kmax;
+        tlab_liss_hint[shape] = 0;
+    }
+}
+
+/*
+  zeta at arc length s_m [m] along a Lissajous curve of radius r [m].
+  The walk starts from the last result, so it is a step or two per tick
+  whichever way s moves
+ */
+float Plane::TLAB_lissajous_zeta(uint8_t shape, float s_m, float r)
+{
+    const float *tab = tlab_liss_s[shape];
+    const float period = tab[TLAB_LISS_TABLE_N];
+
+    if (r <= 0) {
+        return 0;
+    }
+    float s_u = s_m / r;
+    if (s_u <= 0 || period <= 0) {
+        return 0;
+    }
+    float laps = floorf(s_u / period);
+    float rem = s_u - laps*period;
+
+    uint16_t i = tlab_liss_hint[shape];
+    while (i < TLAB_LISS_TABLE_N - 1 && tab[i+1] <= rem) {
+        i++;
+    }
+    while (i > 0 && tab[i] > rem) {
+        i--;
+    }
+    tlab_liss_hint[shape] = i;
+
+    float ds = tab[i+1] - tab[i];
+    float frac = (ds > 0) ? (rem - tab[i]) / ds : 0;
+    return laps*2*M_PI + (i + frac)*TLAB_LISS_DZETA;
+}
+
+/*
+  arc length [m] from zeta = 0 to zeta_end along a Lissajous curve of
+  radius r [m]
+ */
+float Plane::TLAB_lissajous_length(uint8_t shape, float zeta_end, float r)
+{
+    const float *tab = tlab_liss_s[shape];
+    float laps = floorf(zeta_end / (2*M_PI));
+    float rem = (zeta_end - laps*2*M_PI) / TLAB_LISS_DZETA;
+    uint16_t i = MIN((uint16_t)rem, TLAB_LISS_TABLE_N - 1);
+    float s_u = laps*tab[TLAB_LISS_TABLE_N] + tab[i] + (rem - i)*(tab[i+1] - tab[i]);
+    return s_u * r;
+}
+
+/*
+  append a segment, returns false when the list is full
+ */
+bool Plane::TLAB_add_path_segment(const TLAB_Path_Segment &seg)
+{
+    if (tlab_seg_count >= TLAB_PATH_SEG_MAX) {
+        return false;
+    }
+    tlab_seg[tlab_seg_count++] = seg;
+    return true;
+}
+
+/*
+  build the segment list from the cached mission, starting at the
+  current nav command. The path frame is the one set up by
+  init_TLAB_2D_Trace_Controller(): origin Path_Origin, x east, y north.
+  This runs in the fast loop, so it only uses a cache the 10Hz task has
+  already built. Without one the line from prev_WP_loc to next_WP_loc
+  set up by init_TLAB_2D_Trace_Controller() is flown
+ */
+void Plane::TLAB_compile_path_segments(void)
+{
+    tlab_seg_count = 0;
+    tlab_seg_idx = 0;
+
+    if (!tlab_mission_valid) {
+        gcs_send_text(MAV_SEVERITY_WARNING, "TLAB path: mission cache not ready");
+        return;
+    }
+
+    Vector2f cur = tlab_geo_xy(tlab_path_origin, prev_WP_loc);
+    const int8_t liss_shape = g.TPARAM_Liss_Shape;
+    bool full = false;
+
+    for (uint8_t k = 0; !full; k++) {
+        const TLAB_Mission_Item *item = TLAB_mission_lookahead(k);
+        if (item == nullptr) {
+            break;
+        }
+        if (item->loc.lat == 0 && item->loc.lng == 0) {
+            // no position (e.g. NAV_DELAY)
+            continue;
+        }
+        Vector2f p = tlab_geo_xy(tlab_path_origin, item->loc);
+
+        TLAB_Path_Segment seg {};
+        seg.cmd_index = item->index;
+        Vector2f entry;  // where this segment starts
+        Vector2f end;    // where it ends
+
+        switch (item->id) {
+        case MAV_CMD_NAV_LOITER_TURNS:
+        case MAV_CMD_NAV_LOITER_UNLIM: {
+            float radius;
+            if (item->id == MAV_CMD_NAV_LOITER_TURNS) {
+                radius = HIGHBYTE(item->p1);
+            } else {
+                radius = item->p1;
+            }
+            if (radius < 1) {
+                radius = tparam->r;
+            }
+            seg.path_mode = 7;
+            seg.dir = item->loc.flags.loiter_ccw ? 1 : -1;
+            Vector2f d = cur - p;
+            float d_len = d.length();
+            if (d_len > radius) {
+                // join at the tangent point, where the line from cur
+                // already points the way the circle is flown
+                seg.phase0 = atan2f(d.y, d.x) + seg.dir*acosf(radius / d_len);
+            } else {
+                // inside the circle: join at the nearest point, heading
+                // steps by up to 90 degrees
+                seg.phase0 = (d_len > 0.1f) ? atan2f(d.y, d.x) : 0;
+            }
+            seg.p1 = p;
+            seg.r = radius;
+            seg.kappa_max = 1 / radius;
+            if (item->id == MAV_CMD_NAV_LOITER_TURNS) {
+                uint8_t turns = MAX(LOWBYTE(item->p1), 1);
+                seg.length = 2*M_PI*radius*turns;
+            } else {
+                // nothing after an endless loiter can be reached
+                seg.length = 0;
+                full = true;
+            }
+            entry = p + Vector2f(cosf(seg.phase0), sinf(seg.phase0)) * radius;
+            end = entry;
+            break;
+        }
+
+        case MAV_CMD_NAV_LOITER_TIME:
+            if (tparam->r <= 0) {
+                // no size for the curve, fly it as a waypoint
+                seg.path_mode = 0;
+                entry = p;
+                end = p;
+                break;
+            }
+            if (liss_shape == 1) {
+                // figure eight, two laps as in Flight_Plan 2
+                seg.path_mode = 6;
+                seg.r = tparam->r;
+                seg.length = TLAB_lissajous_length(TLAB_LISS_FIG8, 4*M_PI, seg.r);
+                seg.kappa_max = tlab_liss_kappa_max[TLAB_LISS_FIG8] / seg.r;
+                entry = p;
+                end = p;
+            } else if (liss_shape == 2) {
+                // UEC mark, zeta 0 -> PI as in Flight_Plan 3
+                seg.path_mode = 3;
+                seg.r = tparam->r;
+                seg.length = TLAB_lissajous_length(TLAB_LISS_UEC, M_PI, seg.r);
+                seg.kappa_max = tlab_liss_kappa_max[TLAB_LISS_UEC] / seg.r;
+                entry = p + Vector2f(-seg.r, seg.r);
+                end = p + Vector2f(seg.r, seg.r);
+            } else {
+                seg.path_mode = 0;
+                entry = p;
+                end = p;
+                break;
+            }
+            seg.p1 = p;
+            break;
+
+        default:
+            seg.path_mode = 0;
+            entry = p;
+            end = p;
+            break;
+        }
+
+        // line from the end of the previous segment to the start of
+        // this one (for a waypoint this is the segment itself)
+        if ((entry - cur).length() >= 1) {
+            TLAB_Path_Segment line {};
+            line.path_mode = 0;
+            line.cmd_index = item->index;
+            line.p0 = cur;
+            line.p1 = entry;
+            line.length = (entry - cur).length();
+            if (!TLAB_add_path_segment(line)) {
+                full = true;
+                break;
+            }
+        }
+        if (seg.path_mode != 0) {
+            if (!TLAB_add_path_segment(seg)) {
+                full = true;
+                break;
+            }
+        }
+        cur = end;
+    }
+
+    if (tlab_seg_count == 0) {
+        gcs_send_text(MAV_SEVERITY_WARNING, "TLAB path: no segments in mission");
+        return;
+    }
+
+    // one summary message per compile: this runs in the fast loop and
+    // a long mission would otherwise queue a message per segment
+    float total = 0;
+    uint8_t n_steep = 0;
+    uint8_t worst = 0;
+    for (uint8_t i = 0; i < tlab_seg_count; i++) {
+        const TLAB_Path_Segment &seg = tlab_seg[i];
+        total += seg.length;
+        if (seg.kappa_max > kappa_max) {
+            if (n_steep == 0 || seg.kappa_max > tlab_seg[worst].kappa_max) {
+                worst = i;
+            }
+            n_steep++;
+        }
+    }
+    if (n_steep > 0) {
+        gcs_send_text_fmt(MAV_SEVERITY_WARNING, "TLAB path: %u segs over KappaMax, worst cmd %u",
+                          (unsigned)n_steep, (unsigned)tlab_seg[worst].cmd_index);
+    } else {
+        gcs_send_text_fmt(full ? MAV_SEVERITY_WARNING : MAV_SEVERITY_INFO, "TLAB path: %u segs, %.0fm%s%s",
+                          (unsigned)tlab_seg_count, (double)total,
+                          tlab_seg[tlab_seg_count-1].length > 0 ? "" : " + loiter",
+                          full ? " (truncated)" : "");
+    }
+
+    TLAB_set_path_segment(0);
+}
+
+/*
+  make segment idx the one the path generator follows
+ */
+void Plane::TLAB_set_path_segment(uint8_t idx)
+{
+    const TLAB_Path_Segment &seg = tlab_seg[idx];
+    tlab_seg_idx = idx;
+    Path_Mode = seg.path_mode;
+    P0 = seg.p0;
+    P1 = seg.p1;
+    if (Path_Mode == 0) {
+        dist_WPs = seg.length;
+    }
+}
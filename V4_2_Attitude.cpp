@@ -1148,25 +1148,26 @@ int32_t Plane::TLAB_thrust_to_percent(float thrust){
 }
 
 //added by hatae, 2022.3
+// TLAB_Geodesy.h g (XP[͏]ʂ loc2 ̈ܓx)
 float Plane::TLAB_get_distance(const struct Location &loc1, const struct Location &loc2){
-	float dlat=(float)(loc2.lat - loc1.lat);
-	float dlong=((float)(loc2.lng - loc1.lng))*TLAB_longitude_scale(loc2);
-	return norm(dlat, dlong)*LOCATION_SCALING_FACTOR;
+	TLAB_GeoOrigin o;
+	tlab_geo_set_origin(o, loc2);
+	return tlab_geo_distance(o, loc1);
 }
 
 //added by hatae, 2022.3
 float Plane::TLAB_longitude_scale(const struct Location &loc){
-	float scale=cosf(loc.lat*1.0e-7f*DEG_TO_RAD);
-	return constrain_float(scale, 0.01f, 1.0f);
+	TLAB_GeoOrigin o;
+	tlab_geo_set_origin(o, loc);
+	return o.lng_scale;
 }
 
 //added by hatae, 2022.3
 float Plane::TLAB_get_bearing_cd(const struct Location &loc1, const struct Location &loc2){
-	int32_t off_x = loc2.lng - loc1.lng;
-	int32_t off_y = (loc2.lat - loc1.lat) / TLAB_longitude_scale(loc2);
-	int32_t bearing = 9000 + atan2f(-off_y, off_x) * 5729.57795f;
-	if (bearing < 0) bearing += 36000;
-	return bearing;
+	TLAB_GeoOrigin o;
+	tlab_geo_set_origin(o, loc1);
+	o.lng_scale = TLAB_longitude_scale(loc2);
+	return static_cast<int32_t>(degrees(tlab_geo_bearing(o, loc2))*100);
 }
 
 //added by hatae, 2022.3
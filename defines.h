@@ -144,6 +144,10 @@ enum log_messages {
     LOG_PPG_2D_2_MSG,  // Added by Kaito Yamamoto 2021.07.21.
     LOG_PPG_2D_3_MSG,  // Added by Kaito Yamamoto 2021.07.21.
     LOG_PPG_2D_4_MSG,  // Added by Kaito Yamamoto 2021.08.05.
+    LOG_PPG_METRICS_MSG,
+    LOG_PPG_BOOT_MSG,
+    LOG_PPG_FILTER_MSG,
+    LOG_PPG_MISSION_HASH_MSG,
 };
 
 #define MASK_LOG_ATTITUDE_FAST          (1<<0)